@@ -0,0 +1,168 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_ARENAALLOCATOR_H
+#define DATASTRUCTURES_ARENAALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+namespace datastructure {
+
+/****************************************************************************/
+
+namespace detail {
+
+    /// Carves fixed-size blocks out of page-sized chunks, recycling freed blocks
+    /// through per-size free lists. Blocks handed out in sequence are contiguous,
+    /// so node-based containers that allocate as they grow end up with their
+    /// nodes packed together instead of scattered across the heap.
+    class Arena final
+    {
+        struct FreeBlock { FreeBlock * next; };
+    public:
+        static constexpr std::size_t blockAlign = alignof(std::max_align_t);
+        static constexpr std::size_t chunkAlign = 64;   // cache line
+        static constexpr std::size_t chunkSize = 4096;
+        static constexpr std::size_t maxBlockSize = 1024;
+
+        Arena() = default;
+        Arena(const Arena &) = delete;
+        Arena & operator=(const Arena &) = delete;
+
+        ~Arena()
+        {
+            for (auto * chunk : m_chunks) {
+                ::operator delete(chunk, static_cast<std::align_val_t>(chunkAlign));
+            }
+        }
+
+        void * allocate(std::size_t size)
+        {
+            auto klass = sizeClass(size);
+            if (auto * block = m_freeLists[klass]) {
+                m_freeLists[klass] = block->next;
+                return block;
+            }
+            auto rounded = (klass + 1) * blockAlign;
+            // compare remaining space, not m_next + rounded: m_next is null
+            // before the first chunk and after release(), and offsetting a
+            // null pointer is undefined
+            if (rounded > static_cast<std::size_t>(m_limit - m_next)) { grow(); }
+            auto * block = m_next;
+            m_next += rounded;
+            return block;
+        }
+
+        void deallocate(void * ptr, std::size_t size) noexcept
+        {
+            auto klass = sizeClass(size);
+            auto * block = static_cast<FreeBlock *>(ptr);
+            block->next = m_freeLists[klass];
+            m_freeLists[klass] = block;
+        }
+
+        /// Reclaim every block at once, keeping the chunks for reuse.
+        /// All outstanding blocks become invalid — the caller must have
+        /// disposed of every object living in the arena first.
+        void release() noexcept
+        {
+            for (auto & list : m_freeLists) { list = nullptr; }
+            m_used = 0;
+            m_next = m_limit = nullptr;
+        }
+
+    private:
+        static constexpr std::size_t sizeClass(std::size_t size) noexcept
+        {
+            return (size + blockAlign - 1) / blockAlign - 1;
+        }
+
+        void grow()
+        {
+            if (m_used == m_chunks.size()) {
+                auto * chunk = static_cast<std::byte *>(
+                    ::operator new(chunkSize, static_cast<std::align_val_t>(chunkAlign)));
+                m_chunks.push_back(chunk);
+            }
+            auto * chunk = m_chunks[m_used];
+            m_used += 1;
+            m_next = chunk;
+            m_limit = chunk + chunkSize;
+        }
+
+    private:
+        std::vector<std::byte *>    m_chunks;
+        std::size_t                 m_used = 0;     ///< chunks currently in service
+        std::byte *                 m_next = nullptr;
+        std::byte *                 m_limit = nullptr;
+        FreeBlock *                 m_freeLists[maxBlockSize / blockAlign] = {};
+    };
+}
+
+/****************************************************************************/
+
+/// Standard-compatible allocator backed by a shared chunk arena.
+/// Single-object allocations — the only kind node-based containers make — are
+/// a free-list pop or a pointer bump; anything else falls through to operator new.
+template <typename T>
+class ArenaAllocator
+{
+    static constexpr bool fitsArena = sizeof(T) <= detail::Arena::maxBlockSize &&
+                                      alignof(T) <= detail::Arena::blockAlign;
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+public:
+    ArenaAllocator() : m_arena(std::make_shared<detail::Arena>()) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> & other) noexcept : m_arena(other.m_arena) {}
+
+    [[nodiscard]] T * allocate(std::size_t n)
+    {
+        if constexpr (fitsArena) {
+            if (n == 1) { return static_cast<T *>(m_arena->allocate(sizeof(T))); }
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T),
+                                               static_cast<std::align_val_t>(alignof(T))));
+    }
+
+    void deallocate(T * ptr, std::size_t n) noexcept
+    {
+        if constexpr (fitsArena) {
+            if (n == 1) { return m_arena->deallocate(ptr, sizeof(T)); }
+        }
+        ::operator delete(ptr, static_cast<std::align_val_t>(alignof(T)));
+    }
+
+    /// Return every arena block at once, keeping the chunks for reuse.
+    /// Only valid once all objects allocated through this allocator and its
+    /// copies have been destroyed — typically right after the container using
+    /// the arena has been cleared or has gone away.
+    void release() noexcept { m_arena->release(); }
+
+    friend bool operator==(const ArenaAllocator & lhs, const ArenaAllocator & rhs)
+    {
+        return lhs.m_arena == rhs.m_arena;
+    }
+    friend bool operator!=(const ArenaAllocator & lhs, const ArenaAllocator & rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::shared_ptr<detail::Arena>  m_arena;
+
+    template <typename U> friend class ArenaAllocator;
+};
+
+
+} // namespace datastructure
+
+#endif
@@ -0,0 +1,576 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_BTREEMAP_H
+#define DATASTRUCTURES_BTREEMAP_H
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+namespace datastructure {
+
+/****************************************************************************/
+
+/// Sorted map storing many entries per node, B-tree style.
+/// Where a red-black tree touches one cache line per key on the way down, a
+/// B-tree node packs a whole cache line of keys, so a lookup costs one miss
+/// per node instead of one per comparison. Keys and values live in separate
+/// arrays inside the node, keeping the key scan dense.
+///
+/// The interface follows RBTree where the layout allows: since keys and
+/// values are not stored as pairs, iterators yield a pair of references
+/// rather than a reference to a pair. Iterators are invalidated by any
+/// insertion or erasure.
+template <typename K, typename T, typename Compare = std::less<K>>
+class BTreeMap final
+{
+    /// Minimum number of children of a non-root internal node, sized so a
+    /// full node's key array is in the neighbourhood of a cache line
+    static constexpr unsigned minDegree =
+        sizeof(K) >= 32 ? 2 : unsigned(32 / sizeof(K)) < 4 ? 4 : unsigned(32 / sizeof(K));
+    static constexpr unsigned maxKeys = 2 * minDegree - 1;
+
+    struct Node
+    {
+        Node *          parent;
+        std::uint16_t   count;
+        bool            leaf;
+        std::aligned_storage_t<sizeof(K), alignof(K)> keyStore[maxKeys];
+        std::aligned_storage_t<sizeof(T), alignof(T)> valueStore[maxKeys];
+        Node *          children[maxKeys + 1];
+
+        Node(Node * p, bool isLeaf) : parent(p), count(0), leaf(isLeaf) {}
+
+        K & key(unsigned i) noexcept { return *reinterpret_cast<K *>(&keyStore[i]); }
+        const K & key(unsigned i) const noexcept { return *reinterpret_cast<const K *>(&keyStore[i]); }
+        T & value(unsigned i) noexcept { return *reinterpret_cast<T *>(&valueStore[i]); }
+        const T & value(unsigned i) const noexcept { return *reinterpret_cast<const T *>(&valueStore[i]); }
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = T;
+    using value_type = std::pair<const K, T>;
+    using key_compare = Compare;
+    using reference = T &;
+    using const_reference = T const &;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template <bool Const>
+    class IteratorTemplate
+    {
+        using node_type = std::conditional_t<Const, const Node, Node>;
+        using mapped_ref = std::conditional_t<Const, const T &, T &>;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K &, mapped_ref>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        /// Entry handle so `it->first` / `it->second` work on the proxy pair
+        struct pointer
+        {
+            value_type entry;
+            value_type * operator->() noexcept { return &entry; }
+        };
+    public:
+        IteratorTemplate() = default;
+        explicit IteratorTemplate(node_type * node, unsigned slot) : m_node(node), m_slot(slot) {}
+
+        reference operator*() const { return {m_node->key(m_slot), m_node->value(m_slot)}; }
+        pointer operator->() const { return {**this}; }
+
+        IteratorTemplate & operator++()
+        {
+            if (!m_node->leaf) {            // dive to leftmost entry right of this one
+                auto * node = m_node->children[m_slot + 1];
+                while (!node->leaf) { node = node->children[0]; }
+                m_node = node;
+                m_slot = 0;
+            } else if (m_slot + 1 < m_node->count) {
+                m_slot += 1;
+            } else {                        // climb until coming up from a non-last child
+                auto * node = m_node;
+                while (node->parent) {
+                    auto * parent = node->parent;
+                    unsigned slot = 0;
+                    while (parent->children[slot] != node) { slot += 1; }
+                    if (slot < parent->count) { m_node = parent; m_slot = slot; return *this; }
+                    node = parent;
+                }
+                m_node = nullptr;
+                m_slot = 0;
+            }
+            return *this;
+        }
+
+        friend bool operator==(const IteratorTemplate & lhs, const IteratorTemplate & rhs)
+        {
+            return lhs.m_node == rhs.m_node && lhs.m_slot == rhs.m_slot;
+        }
+        friend bool operator!=(const IteratorTemplate & lhs, const IteratorTemplate & rhs) { return !(lhs == rhs); }
+
+        node_type * _node() const noexcept { return m_node; }
+        unsigned _slot() const noexcept { return m_slot; }
+    private:
+        node_type * m_node = nullptr;
+        unsigned    m_slot = 0;
+    };
+    using iterator = IteratorTemplate<false>;
+    using const_iterator = IteratorTemplate<true>;
+
+public:
+    BTreeMap() = default;
+    explicit BTreeMap(const Compare & cmp) : m_compare(cmp) {}
+
+    BTreeMap(const BTreeMap & other) : m_compare(other.m_compare)
+    {
+        for (auto entry : other) { (*this)[entry.first] = entry.second; }
+    }
+
+    BTreeMap(BTreeMap && other) noexcept
+     : m_compare(std::move(other.m_compare)), m_root(other.m_root), m_size(other.m_size)
+    {
+        other.m_root = nullptr;
+        other.m_size = 0;
+    }
+
+    template<typename Iterator>
+    BTreeMap(Iterator from, Iterator to, const Compare & cmp = Compare()) : m_compare(cmp)
+    {
+        for (; from != to; ++from) { this->insert(*from); }
+    }
+
+    BTreeMap(std::initializer_list<value_type> values, const Compare & cmp = Compare())
+     : BTreeMap(values.begin(), values.end(), cmp) {}
+
+    ~BTreeMap() { this->clear(); }
+
+    BTreeMap & operator=(const BTreeMap & rhs)
+    {
+        if (&rhs == this) { return *this; }
+        this->clear();
+        m_compare = rhs.m_compare;
+        for (auto entry : rhs) { (*this)[entry.first] = entry.second; }
+        return *this;
+    }
+
+    BTreeMap & operator=(BTreeMap && rhs) noexcept
+    {
+        this->swap(rhs);
+        return *this;
+    }
+
+    [[nodiscard]] key_compare key_comp() const { return m_compare; }
+
+    reference at(const K & key)
+    {
+        return const_cast<reference>(const_cast<const BTreeMap *>(this)->at(key));
+    }
+
+    const_reference at(const K & key) const
+    {
+        auto it = this->find(key);
+        if (it == this->end()) { throw std::out_of_range("key does not exist"); }
+        return it->second;
+    }
+
+    reference operator[](const K & key)
+    {
+        return this->emplaceKey(key).first->second;
+    }
+
+    reference operator[](K && key)
+    {
+        return this->emplaceKey(std::move(key)).first->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type & value)
+    {
+        auto result = this->emplaceKey(value.first);
+        if (result.second) { result.first->second = value.second; }
+        return result;
+    }
+
+    std::pair<iterator, bool> insert(value_type && value)
+    {
+        auto result = this->emplaceKey(std::move(value.first));
+        if (result.second) { result.first->second = std::move(value.second); }
+        return result;
+    }
+
+    void insert(std::initializer_list<value_type> values)
+    {
+        this->insert(values.begin(), values.end());
+    }
+
+    template<typename Iterator> void insert(Iterator first, Iterator last)
+    {
+        for (; first != last; ++first) { this->insert(*first); }
+    }
+
+    void erase(const K & key)
+    {
+        if (!m_root) { return; }
+        if (eraseFrom(m_root, key)) { m_size -= 1; }
+        if (m_root->count == 0) {       // tree shrinks by one level
+            auto * old = m_root;
+            m_root = m_root->leaf ? nullptr : m_root->children[0];
+            if (m_root) { m_root->parent = nullptr; }
+            old->~Node();
+            ::operator delete(old);
+        }
+    }
+
+    // by copy: erasure shuffles entries around, the iterator's reference would dangle
+    void erase(iterator it) { K key = it->first; this->erase(key); }
+    void erase(const_iterator it) { K key = it->first; this->erase(key); }
+
+    [[nodiscard]] iterator find(const K & key)
+    {
+        auto it = const_cast<const BTreeMap *>(this)->find(key);
+        return iterator(const_cast<Node *>(it._node()), it._slot());
+    }
+
+    [[nodiscard]] const_iterator find(const K & key) const
+    {
+        const Node * node = m_root;
+        while (node) {
+            auto slot = lowerSlot(*node, key);
+            if (slot < node->count && !m_compare(key, node->key(slot))) {
+                return const_iterator(node, slot);
+            }
+            node = node->leaf ? nullptr : node->children[slot];
+        }
+        return const_iterator();
+    }
+
+    [[nodiscard]] iterator begin()
+    {
+        auto it = const_cast<const BTreeMap *>(this)->begin();
+        return iterator(const_cast<Node *>(it._node()), it._slot());
+    }
+    [[nodiscard]] const_iterator begin() const
+    {
+        auto * node = m_root;
+        if (!node) { return const_iterator(); }
+        while (!node->leaf) { node = node->children[0]; }
+        return const_iterator(node, 0);
+    }
+    [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+    [[nodiscard]] iterator end() { return iterator(); }
+    [[nodiscard]] const_iterator end() const { return const_iterator(); }
+    [[nodiscard]] const_iterator cend() const { return const_iterator(); }
+
+    void clear()
+    {
+        if (m_root) { destroySubtree(m_root); }
+        m_root = nullptr;
+        m_size = 0;
+    }
+
+    void swap(BTreeMap & rhs) noexcept
+    {
+        using std::swap;
+        swap(m_compare, rhs.m_compare);
+        swap(m_root, rhs.m_root);
+        swap(m_size, rhs.m_size);
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] size_type max_size() const noexcept
+    {
+        return std::numeric_limits<size_type>::max() / sizeof(Node);
+    }
+
+    friend bool operator==(const BTreeMap & lhs, const BTreeMap & rhs)
+    {
+        if (lhs.m_size != rhs.m_size) { return false; }
+        auto lit = lhs.cbegin();
+        auto rit = rhs.cbegin();
+        for (; lit != lhs.cend(); ++lit, ++rit) {
+            if (lit->first != rit->first || lit->second != rit->second) { return false; }
+        }
+        return true;
+    }
+    friend bool operator!=(const BTreeMap & lhs, const BTreeMap & rhs) { return !(lhs == rhs); }
+
+private:
+    static Node * buildNode(Node * parent, bool leaf)
+    {
+        auto * storage = ::operator new(sizeof(Node));
+        return new (storage) Node(parent, leaf);
+    }
+
+    static void destroySubtree(Node * node)
+    {
+        if (!node->leaf) {
+            for (unsigned i = 0; i <= node->count; ++i) { destroySubtree(node->children[i]); }
+        }
+        for (unsigned i = 0; i < node->count; ++i) {
+            node->key(i).~K();
+            node->value(i).~T();
+        }
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    /// First slot whose key is not less than the searched one — a short linear
+    /// scan, the whole key array sits on one or two cache lines
+    unsigned lowerSlot(const Node & node, const K & key) const
+    {
+        unsigned slot = 0;
+        while (slot < node.count && m_compare(node.key(slot), key)) { slot += 1; }
+        return slot;
+    }
+
+    /// Split full child node.children[slot] around its median key, which moves
+    /// up into node at slot. node must not be full.
+    void splitChild(Node * node, unsigned slot)
+    {
+        auto * child = node->children[slot];
+        auto * sibling = buildNode(node, child->leaf);
+
+        for (unsigned i = 0; i < minDegree - 1; ++i) {      // upper half moves to sibling
+            new (&sibling->keyStore[i]) K(std::move(child->key(minDegree + i)));
+            new (&sibling->valueStore[i]) T(std::move(child->value(minDegree + i)));
+            child->key(minDegree + i).~K();
+            child->value(minDegree + i).~T();
+        }
+        if (!child->leaf) {
+            for (unsigned i = 0; i < minDegree; ++i) {
+                sibling->children[i] = child->children[minDegree + i];
+                sibling->children[i]->parent = sibling;
+            }
+        }
+        sibling->count = minDegree - 1;
+
+        for (unsigned i = node->count; i > slot; --i) {     // shift node entries right
+            new (&node->keyStore[i]) K(std::move(node->key(i - 1)));
+            new (&node->valueStore[i]) T(std::move(node->value(i - 1)));
+            node->key(i - 1).~K();
+            node->value(i - 1).~T();
+            node->children[i + 1] = node->children[i];
+        }
+        new (&node->keyStore[slot]) K(std::move(child->key(minDegree - 1)));
+        new (&node->valueStore[slot]) T(std::move(child->value(minDegree - 1)));
+        child->key(minDegree - 1).~K();
+        child->value(minDegree - 1).~T();
+        node->children[slot + 1] = sibling;
+        node->count += 1;
+        child->count = minDegree - 1;
+    }
+
+    /// Find or create the entry for a key, splitting full nodes on the way down
+    /// so the insertion leaf always has room
+    template <typename KeyU>
+    std::pair<iterator, bool> emplaceKey(KeyU && key)
+    {
+        if (!m_root) {
+            m_root = buildNode(nullptr, true);
+        }
+        if (m_root->count == maxKeys) {
+            auto * top = buildNode(nullptr, false);
+            top->children[0] = m_root;
+            m_root->parent = top;
+            m_root = top;
+            splitChild(top, 0);
+        }
+
+        auto * node = m_root;
+        for (;;) {
+            auto slot = lowerSlot(*node, key);
+            if (slot < node->count && !m_compare(key, node->key(slot))) {
+                return {iterator(node, slot), false};
+            }
+            if (node->leaf) {
+                for (unsigned i = node->count; i > slot; --i) {
+                    new (&node->keyStore[i]) K(std::move(node->key(i - 1)));
+                    new (&node->valueStore[i]) T(std::move(node->value(i - 1)));
+                    node->key(i - 1).~K();
+                    node->value(i - 1).~T();
+                }
+                new (&node->keyStore[slot]) K(std::forward<KeyU>(key));
+                new (&node->valueStore[slot]) T();
+                node->count += 1;
+                m_size += 1;
+                return {iterator(node, slot), true};
+            }
+            if (node->children[slot]->count == maxKeys) {
+                splitChild(node, slot);
+                continue;       // re-scan: the median just moved up beside slot
+            }
+            node = node->children[slot];
+        }
+    }
+
+    //
+    // Erasure — CLRS shape: make sure a child holds at least minDegree entries
+    // before descending into it, so removal never has to walk back up
+    //
+
+    void removeAt(Node * node, unsigned slot)
+    {
+        node->key(slot).~K();
+        node->value(slot).~T();
+        for (unsigned i = slot; i + 1 < node->count; ++i) {
+            new (&node->keyStore[i]) K(std::move(node->key(i + 1)));
+            new (&node->valueStore[i]) T(std::move(node->value(i + 1)));
+            node->key(i + 1).~K();
+            node->value(i + 1).~T();
+        }
+        node->count -= 1;
+    }
+
+    bool eraseFrom(Node * node, const K & key)
+    {
+        auto slot = lowerSlot(*node, key);
+        const bool match = slot < node->count && !m_compare(key, node->key(slot));
+
+        if (node->leaf) {
+            if (!match) { return false; }
+            removeAt(node, slot);
+            return true;
+        }
+
+        if (match) {
+            auto * before = node->children[slot];
+            auto * after = node->children[slot + 1];
+            if (before->count >= minDegree) {           // pull up in-order predecessor
+                auto * leaf = before;
+                while (!leaf->leaf) { leaf = leaf->children[leaf->count]; }
+                // key is copied, not moved: the original must stay findable
+                // for the recursive removal below
+                node->key(slot) = leaf->key(leaf->count - 1);
+                node->value(slot) = std::move(leaf->value(leaf->count - 1));
+                return eraseFrom(before, node->key(slot));
+            }
+            if (after->count >= minDegree) {            // pull up in-order successor
+                auto * leaf = after;
+                while (!leaf->leaf) { leaf = leaf->children[0]; }
+                node->key(slot) = leaf->key(0);
+                node->value(slot) = std::move(leaf->value(0));
+                return eraseFrom(after, node->key(slot));
+            }
+            mergeChildren(node, slot);                  // both minimal: merge and retry inside
+            // the separator — which matched — now sits in the merged node;
+            // search for it rather than through key, which may alias it
+            return eraseFrom(before, before->key(minDegree - 1));
+        }
+
+        auto * child = node->children[slot];
+        if (child->count < minDegree) {
+            slot = refillChild(node, slot);
+            child = node->children[slot];
+        }
+        return eraseFrom(child, key);
+    }
+
+    /// Bring node.children[slot] up to at least minDegree entries by borrowing
+    /// from a sibling or merging with one. Returns the slot the child (or the
+    /// merged node containing it) ends up at.
+    unsigned refillChild(Node * node, unsigned slot)
+    {
+        auto * child = node->children[slot];
+
+        if (slot > 0 && node->children[slot - 1]->count >= minDegree) {
+            auto * left = node->children[slot - 1];     // rotate through separator
+            for (unsigned i = child->count; i > 0; --i) {
+                new (&child->keyStore[i]) K(std::move(child->key(i - 1)));
+                new (&child->valueStore[i]) T(std::move(child->value(i - 1)));
+                child->key(i - 1).~K();
+                child->value(i - 1).~T();
+            }
+            if (!child->leaf) {
+                for (unsigned i = child->count + 1; i > 0; --i) { child->children[i] = child->children[i - 1]; }
+                child->children[0] = left->children[left->count];
+                child->children[0]->parent = child;
+            }
+            new (&child->keyStore[0]) K(std::move(node->key(slot - 1)));
+            new (&child->valueStore[0]) T(std::move(node->value(slot - 1)));
+            child->count += 1;
+            node->key(slot - 1) = std::move(left->key(left->count - 1));
+            node->value(slot - 1) = std::move(left->value(left->count - 1));
+            left->key(left->count - 1).~K();
+            left->value(left->count - 1).~T();
+            left->count -= 1;
+            return slot;
+        }
+
+        if (slot < node->count && node->children[slot + 1]->count >= minDegree) {
+            auto * right = node->children[slot + 1];    // rotate the other way
+            new (&child->keyStore[child->count]) K(std::move(node->key(slot)));
+            new (&child->valueStore[child->count]) T(std::move(node->value(slot)));
+            if (!child->leaf) {
+                child->children[child->count + 1] = right->children[0];
+                child->children[child->count + 1]->parent = child;
+            }
+            child->count += 1;
+            node->key(slot) = std::move(right->key(0));
+            node->value(slot) = std::move(right->value(0));
+            removeAt(right, 0);
+            if (!right->leaf) {
+                for (unsigned i = 0; i <= right->count; ++i) { right->children[i] = right->children[i + 1]; }
+            }
+            return slot;
+        }
+
+        if (slot < node->count) { mergeChildren(node, slot); return slot; }
+        mergeChildren(node, slot - 1);
+        return slot - 1;
+    }
+
+    /// Merge node.children[slot], the separator at slot, and node.children[slot+1]
+    /// into a single node — both children hold minDegree-1 entries.
+    void mergeChildren(Node * node, unsigned slot)
+    {
+        auto * left = node->children[slot];
+        auto * right = node->children[slot + 1];
+
+        new (&left->keyStore[left->count]) K(std::move(node->key(slot)));
+        new (&left->valueStore[left->count]) T(std::move(node->value(slot)));
+        for (unsigned i = 0; i < right->count; ++i) {
+            new (&left->keyStore[left->count + 1 + i]) K(std::move(right->key(i)));
+            new (&left->valueStore[left->count + 1 + i]) T(std::move(right->value(i)));
+            right->key(i).~K();
+            right->value(i).~T();
+        }
+        if (!left->leaf) {
+            for (unsigned i = 0; i <= right->count; ++i) {
+                left->children[left->count + 1 + i] = right->children[i];
+                left->children[left->count + 1 + i]->parent = left;
+            }
+        }
+        left->count = static_cast<std::uint16_t>(left->count + right->count + 1);
+
+        removeAt(node, slot);                           // drop the separator
+        for (unsigned i = slot + 1; i <= node->count; ++i) { node->children[i] = node->children[i + 1]; }
+
+        right->~Node();
+        ::operator delete(right);
+    }
+
+private:
+    Compare     m_compare;
+    Node *      m_root = nullptr;
+    size_type   m_size = 0;
+};
+
+template<typename K, typename T, typename Compare>
+void swap(BTreeMap<K, T, Compare> & lhs, BTreeMap<K, T, Compare> & rhs) { lhs.swap(rhs); }
+
+/****************************************************************************/
+
+} // namespace datastructure
+
+#endif
@@ -0,0 +1,110 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_FROZENTREE_H
+#define DATASTRUCTURES_FROZENTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+namespace datastructure {
+
+/****************************************************************************/
+
+/// Read-only search tree snapshot for build-once, query-many workloads.
+/// Keys are packed into a dense array in implicit level order — children of
+/// slot k live at 2k and 2k+1, so the structure needs no pointers at all and
+/// the whole top of the tree shares a handful of cache lines. Values live in
+/// a parallel array that is only touched on a hit.
+///
+/// Mapped values must be default-constructible and copy-assignable.
+template <typename K, typename T, typename Compare = std::less<K>>
+class FrozenTree final
+{
+public:
+    using key_type = K;
+    using mapped_type = T;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+
+public:
+    FrozenTree() = default;
+
+    /// Build from a range sorted according to cmp, such as an RBTree traversal
+    template <typename Iterator>
+    FrozenTree(Iterator first, Iterator last, const Compare & cmp = Compare())
+     : m_cmp(cmp),
+       m_size(size_type(std::distance(first, last)))
+    {
+        m_keys.resize(m_size + 1);      // slot 0 unused, children of k are 2k / 2k+1
+        m_values.resize(m_size + 1);
+        fill(first, 1);
+    }
+
+    [[nodiscard]] const T * find(const K & key) const
+    {
+        auto slot = lowerBound(key);
+        if (slot == 0 || m_cmp(key, m_keys[slot])) { return nullptr; }
+        return &m_values[slot];
+    }
+
+    [[nodiscard]] bool contains(const K & key) const { return this->find(key) != nullptr; }
+
+    const T & at(const K & key) const
+    {
+        const auto * value = this->find(key);
+        if (!value) { throw std::out_of_range("key does not exist"); }
+        return *value;
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+private:
+    template <typename Iterator>
+    Iterator fill(Iterator it, size_type slot)
+    {
+        if (slot > m_size) { return it; }
+        it = fill(it, 2 * slot);
+        m_keys[slot] = it->first;
+        m_values[slot] = it->second;
+        ++it;
+        return fill(it, 2 * slot + 1);
+    }
+
+    /// Slot of the first key not less than key, or 0 if none. The descent is a
+    /// tight loop over the key array with no pointer chasing; the final slot is
+    /// recovered by unwinding the trailing right-turns recorded in the index bits.
+    size_type lowerBound(const K & key) const
+    {
+        size_type slot = 1;
+        while (slot <= m_size) {
+            slot = 2 * slot + size_type(m_cmp(m_keys[slot], key));
+        }
+        while (slot & 1) { slot >>= 1; }
+        return slot >> 1;
+    }
+
+private:
+    Compare         m_cmp;
+    size_type       m_size = 0;
+    std::vector<K>  m_keys;
+    std::vector<T>  m_values;
+};
+
+/// Snapshot any sorted associative container into a FrozenTree
+template <typename Tree>
+auto freeze(const Tree & tree)
+{
+    using Frozen = FrozenTree<typename Tree::key_type, typename Tree::mapped_type,
+                              typename Tree::key_compare>;
+    return Frozen(tree.begin(), tree.end(), tree.key_comp());
+}
+
+
+} // namespace datastructure
+
+#endif
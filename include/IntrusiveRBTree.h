@@ -0,0 +1,192 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_INTRUSIVERBTREE_H
+#define DATASTRUCTURES_INTRUSIVERBTREE_H
+
+#include <functional>
+#include "rbtree.h"
+
+
+namespace datastructure {
+
+/****************************************************************************/
+
+/// Link header to embed in objects stored in an IntrusiveRBTree.
+/// Derive from it so the tree links live inside the object itself — lookups
+/// and iteration reach the object in the same cache line as the links,
+/// with no separately allocated node in between.
+struct RBHook : detail::NodeBase {};
+
+/****************************************************************************/
+
+/// Red-black tree of externally-owned objects deriving from RBHook.
+/// The tree never allocates or destroys elements: insert links an object the
+/// caller owns, erase unlinks it, and clearing the tree simply forgets them.
+/// An object may be linked into at most one tree at a time.
+///
+/// Compare orders whole objects; find accepts any key the comparator can
+/// order against them, hence the transparent default.
+template <typename T, typename Compare = std::less<>>
+class IntrusiveRBTree final
+{
+    static_assert(std::is_base_of_v<RBHook, T>, "T must derive from RBHook");
+public:
+    using value_type = T;
+    using key_compare = Compare;
+    using reference = T &;
+    using const_reference = T const &;
+    using size_type = std::size_t;
+
+    template <bool Const>
+    class IteratorTemplate
+    {
+        using tree_type = std::conditional_t<Const, const detail::TreeBase, detail::TreeBase>;
+        using node_type = std::conditional_t<Const, const detail::NodeBase, detail::NodeBase>;
+        using object_type = std::conditional_t<Const, const T, T>;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = object_type;
+        using reference = object_type &;
+        using pointer = object_type *;
+        using difference_type = std::ptrdiff_t;
+    public:
+        IteratorTemplate() = default;
+        explicit IteratorTemplate(tree_type & tree, node_type * node) : m_tree(&tree), m_node(node) {}
+
+        reference operator*() const { return *static_cast<pointer>(m_node); }
+        pointer operator->() const { return static_cast<pointer>(m_node); }
+
+        IteratorTemplate & operator++() { m_node = successor(*m_tree, m_node); return *this; }
+        IteratorTemplate & operator--() { m_node = predecessor(*m_tree, m_node); return *this; }
+
+        friend bool operator==(const IteratorTemplate & lhs, const IteratorTemplate & rhs)
+        {
+            return lhs.m_node == rhs.m_node;
+        }
+        friend bool operator!=(const IteratorTemplate & lhs, const IteratorTemplate & rhs) { return !(lhs == rhs); }
+    private:
+        tree_type * m_tree = nullptr;
+        node_type * m_node = nullptr;
+    };
+    using iterator = IteratorTemplate<false>;
+    using const_iterator = IteratorTemplate<true>;
+
+public:
+    IntrusiveRBTree()
+    {
+        m_nil.left = m_nil.right = &m_nil;
+        m_nil.setColor(detail::Color::Black);
+        m_data.nil = m_data.root = &m_nil;
+    }
+
+    explicit IntrusiveRBTree(const Compare & cmp) : IntrusiveRBTree() { m_compare = cmp; }
+
+    // leaf hooks point at the embedded nil, so the tree cannot change address
+    IntrusiveRBTree(const IntrusiveRBTree &) = delete;
+    IntrusiveRBTree & operator=(const IntrusiveRBTree &) = delete;
+
+    /// Link an object into the tree. Returns false, leaving the tree unchanged,
+    /// if an equivalent object is already linked.
+    bool insert(T & item)
+    {
+        auto where = findPos(item);
+        if (where.side == 0) { return false; }
+
+        auto * node = static_cast<detail::NodeBase *>(&item);
+        node->left = node->right = &m_nil;
+        node->setParent(where.node);
+        node->setColor(detail::Color::Red);
+        if (where.node == &m_nil) {
+            m_data.root = node;
+        } else if (where.side < 0) {
+            where.node->left = node;
+        } else {
+            where.node->right = node;
+        }
+        insertFixup(m_data, node);
+        m_size += 1;
+        return true;
+    }
+
+    /// Unlink an object. It must currently be linked in this tree.
+    void erase(T & item)
+    {
+        extractNode(m_data, static_cast<detail::NodeBase *>(&item));
+        m_size -= 1;
+    }
+
+    template <typename Key>
+    [[nodiscard]] T * find(const Key & key)
+    {
+        return const_cast<T *>(const_cast<const IntrusiveRBTree *>(this)->find(key));
+    }
+
+    template <typename Key>
+    [[nodiscard]] const T * find(const Key & key) const
+    {
+        auto where = findPos(key);
+        if (where.side != 0) { return nullptr; }
+        return static_cast<const T *>(where.node);
+    }
+
+    /// Forget all linked objects without touching them
+    void clear() noexcept
+    {
+        m_data.root = &m_nil;
+        m_size = 0;
+    }
+
+    [[nodiscard]] iterator begin() { return iterator(m_data, allLeft(m_data.root)); }
+    [[nodiscard]] const_iterator begin() const { return const_iterator(m_data, allLeft(m_data.root)); }
+    [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+    [[nodiscard]] iterator end() { return iterator(m_data, nullptr); }
+    [[nodiscard]] const_iterator end() const { return const_iterator(m_data, nullptr); }
+    [[nodiscard]] const_iterator cend() const { return this->end(); }
+
+    [[nodiscard]] size_type size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] key_compare key_comp() const { return m_compare; }
+
+private:
+    /// Same deferred-equality descent as the owning tree's findNode, comparing
+    /// against the objects themselves
+    template <typename Key>
+    detail::FindResult<const detail::NodeBase> findPos(const Key & key) const
+    {
+        const detail::NodeBase * node = m_data.root;
+        const detail::NodeBase * next = node;
+        const detail::NodeBase * candidate = nullptr;
+        bool less = false;
+        while (next != &m_nil) {
+            node = next;
+            DATASTRUCTURES_PREFETCH(node->left);
+            DATASTRUCTURES_PREFETCH(node->right);
+            less = m_compare(key, *static_cast<const T *>(node));
+            candidate = less ? candidate : node;
+            next = less ? node->left : node->right;
+        }
+        if (candidate && !m_compare(*static_cast<const T *>(candidate), key)) {
+            return {candidate, 0};
+        }
+        return {node, less ? -1 : 1};
+    }
+
+    template <typename Key>
+    detail::FindResult<detail::NodeBase> findPos(const Key & key)
+    {
+        auto found = const_cast<const IntrusiveRBTree *>(this)->findPos(key);
+        return {const_cast<detail::NodeBase *>(found.node), found.side};
+    }
+
+private:
+    detail::NodeBase    m_nil;
+    detail::TreeBase    m_data;
+    Compare             m_compare;
+    size_type           m_size = 0;
+};
+
+/****************************************************************************/
+
+} // namespace datastructure
+
+#endif
@@ -0,0 +1,97 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_MPMCRINGBUFFER_H
+#define DATASTRUCTURES_MPMCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace datastructure {
+
+/// Lock-free multi-producer / multi-consumer exchange buffer.
+/// Instead of shared head/tail indices — which every producer and consumer
+/// would bounce between caches on each operation — storage is an array of
+/// item pointers where nullptr means empty. Producers claim an empty slot
+/// with a compare-and-swap, consumers claim a full one; threads working on
+/// different slots never touch the same location. Per-side hints keep the
+/// scans short in steady state.
+///
+/// The buffer does not own the items: producers keep ownership until
+/// try_push succeeds, and it transfers to whoever pops the pointer.
+/// Ordering is approximately FIFO but not guaranteed under contention.
+template <typename T, std::size_t Slots>
+class MpmcRingBuffer final
+{
+    static_assert((Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+public:
+    using value_type = T *;
+    using size_type = std::size_t;
+
+public:
+    MpmcRingBuffer() noexcept = default;
+    MpmcRingBuffer(const MpmcRingBuffer &) = delete;
+    MpmcRingBuffer & operator=(const MpmcRingBuffer &) = delete;
+
+    /// Publish an item, returning false if no slot was free. item must not be null.
+    bool try_push(T * item) noexcept
+    {
+        auto start = m_pushHint.load(std::memory_order_relaxed);
+        for (size_type i = 0; i < Slots; ++i) {
+            auto & slot = m_slots[(start + i) & mask];
+            T * expected = nullptr;
+            if (slot.load(std::memory_order_relaxed) == nullptr &&
+                slot.compare_exchange_strong(expected, item,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+                m_pushHint.store(start + i + 1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Take an item out, or return nullptr if the buffer was empty
+    T * try_pop() noexcept
+    {
+        auto start = m_popHint.load(std::memory_order_relaxed);
+        for (size_type i = 0; i < Slots; ++i) {
+            auto & slot = m_slots[(start + i) & mask];
+            auto * item = slot.load(std::memory_order_relaxed);
+            if (item != nullptr &&
+                slot.compare_exchange_strong(item, nullptr,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+                m_popHint.store(start + i + 1, std::memory_order_relaxed);
+                return item;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Approximate while other threads are active
+    [[nodiscard]] size_type size() const noexcept
+    {
+        size_type count = 0;
+        for (const auto & slot : m_slots) {
+            if (slot.load(std::memory_order_relaxed) != nullptr) { count += 1; }
+        }
+        return count;
+    }
+    [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+    [[nodiscard]] size_type capacity() const noexcept { return Slots; }
+    [[nodiscard]] size_type max_size() const noexcept { return Slots; }
+
+private:
+    static constexpr size_type mask = Slots - 1;
+
+private:
+    std::atomic<T *>    m_slots[Slots] = {};
+    alignas(64) std::atomic<size_type> m_pushHint{0};
+    alignas(64) std::atomic<size_type> m_popHint{0};
+};
+
+
+} // namespace datastructure
+
+#endif
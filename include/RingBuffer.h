@@ -3,8 +3,21 @@
 #ifndef DATASTRUCTURES_RINGBUFFER_H
 #define DATASTRUCTURES_RINGBUFFER_H
 
+#include <algorithm>
+#include <cstring>
 #include <new>
 #include <type_traits>
+#include <utility>
+
+/// Overrides compiler size heuristics for the tiny hot-path members, which
+/// callers invariably use inside their own tightest loops.
+#if defined(__GNUC__) || defined(__clang__)
+#   define DS_FORCE_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#   define DS_FORCE_INLINE __forceinline
+#else
+#   define DS_FORCE_INLINE inline
+#endif
 
 
 namespace datastructure {
@@ -30,84 +43,127 @@ public:
     RingBuffer & operator=(const RingBuffer &) = delete;
 
 #ifdef __cpp_lib_launder
-    reference       front() { return *std::launder(reinterpret_cast<T*>(m_read)); }
-    const_reference front() const { return *std::launder(reinterpret_cast<const T*>(m_read)); };
+    DS_FORCE_INLINE reference       front() { return *std::launder(reinterpret_cast<T*>(&m_storage[m_read])); }
+    DS_FORCE_INLINE const_reference front() const { return *std::launder(reinterpret_cast<const T*>(&m_storage[m_read])); };
 #else
-    reference       front() { return *reinterpret_cast<T*>(m_read); }
-    const_reference front() const { return *reinterpret_cast<const T*>(m_read); };
+    DS_FORCE_INLINE reference       front() { return *reinterpret_cast<T*>(&m_storage[m_read]); }
+    DS_FORCE_INLINE const_reference front() const { return *reinterpret_cast<const T*>(&m_storage[m_read]); };
 #endif
 
     template <typename U = T>
-    std::enable_if_t<std::is_copy_constructible_v<U>, void>
+    DS_FORCE_INLINE std::enable_if_t<std::is_copy_constructible_v<U>, void>
     push(const T & val) noexcept(std::is_nothrow_copy_constructible_v<U>)
     {
-        new (m_write) T(val);
-        if (++m_write >= storageEnd()) { m_write = storageBegin(); }
-        if (m_write == m_read) { m_write = nullptr; }
+        new (&m_storage[m_write]) T(val);
+        m_write = next(m_write);
+        m_count += 1;
     }
 
     template <typename U = T>
-    std::enable_if_t<std::is_move_constructible_v<U>, void>
+    DS_FORCE_INLINE std::enable_if_t<std::is_move_constructible_v<U>, void>
     push(T && val) noexcept(std::is_nothrow_move_constructible_v<U>)
     {
-        new (m_write) T(std::move(val));
-        if (++m_write >= storageEnd()) { m_write = storageBegin(); }
-        if (m_write == m_read) { m_write = nullptr; }
+        new (&m_storage[m_write]) T(std::move(val));
+        m_write = next(m_write);
+        m_count += 1;
     }
 
     template<typename ... Args>
-    void emplace(Args && ... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    DS_FORCE_INLINE void emplace(Args && ... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        new (&m_storage[m_write]) T(std::forward<Args>(args)...);
+        m_write = next(m_write);
+        m_count += 1;
+    }
+
+    /// Copy up to n elements into the buffer, returning how many fit.
+    /// Lowers to at most two memcpy calls — one up to the wrap point, one after.
+    template <typename U = T>
+    std::enable_if_t<std::is_trivially_copyable_v<U>, size_type>
+    push_bulk(const T * src, size_type n) noexcept
+    {
+        n = std::min(n, Slots - m_count);
+        auto first = std::min(n, Slots - m_write);
+        std::memcpy(&m_storage[m_write], src, first * sizeof(T));
+        std::memcpy(&m_storage[0], src + first, (n - first) * sizeof(T));
+        m_write = next(m_write, n);
+        m_count += n;
+        return n;
+    }
+
+    /// Copy up to n elements out of the buffer, returning how many were there
+    template <typename U = T>
+    std::enable_if_t<std::is_trivially_copyable_v<U>, size_type>
+    pop_bulk(T * dst, size_type n) noexcept
     {
-        new (m_write) T(std::forward<Args>(args)...);
-        if (++m_write >= storageEnd()) { m_write = storageBegin(); }
-        if (m_write == m_read) { m_write = nullptr; }
+        n = std::min(n, m_count);
+        auto first = std::min(n, Slots - m_read);
+        std::memcpy(dst, &m_storage[m_read], first * sizeof(T));
+        std::memcpy(dst + first, &m_storage[0], (n - first) * sizeof(T));
+        m_read = next(m_read, n);
+        m_count -= n;
+        return n;
     }
 
-    void pop() noexcept(std::is_nothrow_destructible_v<T>)
+    DS_FORCE_INLINE void pop() noexcept(std::is_nothrow_destructible_v<T>)
     {
+        // skipped at compile time for trivial types, so batched pops reduce to index math
+        if constexpr (!std::is_trivially_destructible_v<T>) {
 #ifdef __cpp_lib_launder
-        std::launder(reinterpret_cast<T*>(m_read))->~T();
+            std::launder(reinterpret_cast<T*>(&m_storage[m_read]))->~T();
 #else
-        reinterpret_cast<T*>(m_read)->~T();
+            reinterpret_cast<T*>(&m_storage[m_read])->~T();
 #endif
-        if (!m_write) { m_write = m_read; }
-        if (++m_read >= storageEnd()) { m_read = storageBegin(); }
+        }
+        m_read = next(m_read);
+        m_count -= 1;
     }
 
-    void clear() noexcept(std::is_nothrow_destructible_v<T>)
+    DS_FORCE_INLINE void clear() noexcept(std::is_nothrow_destructible_v<T>)
     {
         if constexpr (std::is_trivially_destructible_v<T>) {
-            m_write = m_read;
+            m_read = m_write;
+            m_count = 0;
         } else {
             while (!this->empty()) { this->pop(); }
         }
     }
 
-    [[nodiscard]] bool empty() const noexcept
+    [[nodiscard]] DS_FORCE_INLINE bool empty() const noexcept
     {
-        return m_read == m_write;
+        return m_count == 0;
     }
 
-    [[nodiscard]] size_type size() const noexcept
+    [[nodiscard]] DS_FORCE_INLINE bool full() const noexcept
     {
-        return m_write == nullptr ? Slots
-             : m_read <= m_write  ? size_type(m_write - m_read)
-                                  : size_type(storageEnd() - m_read) +
-                                    size_type(m_write - storageBegin());
+        return m_count == Slots;
+    }
+
+    [[nodiscard]] DS_FORCE_INLINE size_type size() const noexcept
+    {
+        return m_count;
     }
 
     [[nodiscard]] size_type capacity() const noexcept { return Slots; }
     [[nodiscard]] size_type max_size() const noexcept { return Slots; }
 
 private:
-    [[nodiscard]] slot_type *       storageBegin() noexcept { return &m_storage[0]; }
-    [[nodiscard]] const slot_type * storageBegin() const noexcept { return &m_storage[0]; }
-    [[nodiscard]] slot_type *       storageEnd() noexcept { return storageBegin() + Slots; }
-    [[nodiscard]] const slot_type * storageEnd() const noexcept { return storageBegin() + Slots; }
+    /// Advance an index, wrapping around. A single AND when Slots is a power of two.
+    static constexpr size_type next(size_type index, size_type distance = 1) noexcept
+    {
+        if constexpr ((Slots & (Slots - 1)) == 0) {
+            return (index + distance) & (Slots - 1);
+        } else {
+            index += distance;
+            return index >= Slots ? index - Slots : index;
+        }
+    }
+
 private:
     slot_type   m_storage[Slots];
-    slot_type * m_read = &m_storage[0];
-    slot_type * m_write = &m_storage[0];    ///< nullptr when buffer is full
+    size_type   m_read = 0;
+    size_type   m_write = 0;
+    size_type   m_count = 0;
 };
 
 
@@ -0,0 +1,101 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#ifndef DATASTRUCTURES_SPSCRINGBUFFER_H
+#define DATASTRUCTURES_SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace datastructure {
+
+/// Wait-free single-producer / single-consumer ring buffer.
+/// Producer and consumer indices live on separate cache lines so the two
+/// threads never write the same line; each operation is one relaxed load of
+/// the own index, one acquire load of the other side's, and a release store.
+/// Indices count monotonically and are masked on access, which keeps the
+/// full/empty distinction without a sentinel slot.
+template <typename T, std::size_t Slots>
+class SpscRingBuffer final
+{
+    using slot_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    static_assert((Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+public:
+    SpscRingBuffer() noexcept = default;
+    ~SpscRingBuffer()
+    {
+        auto read = m_read.load(std::memory_order_relaxed);
+        auto write = m_write.load(std::memory_order_relaxed);
+        for (; read != write; ++read) { slot(read)->~T(); }
+    }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer & operator=(const SpscRingBuffer &) = delete;
+
+    //*** producer side ***
+
+    bool try_push(const T & val) { return this->try_emplace(val); }
+    bool try_push(T && val) { return this->try_emplace(std::move(val)); }
+
+    template <typename ... Args>
+    bool try_emplace(Args && ... args)
+    {
+        auto write = m_write.load(std::memory_order_relaxed);
+        if (write - m_read.load(std::memory_order_acquire) == Slots) { return false; }
+        new (&m_storage[write & mask]) T(std::forward<Args>(args)...);
+        m_write.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    //*** consumer side ***
+
+    bool try_pop(T & out)
+    {
+        auto read = m_read.load(std::memory_order_relaxed);
+        if (m_write.load(std::memory_order_acquire) == read) { return false; }
+        auto * item = slot(read);
+        out = std::move(*item);
+        item->~T();
+        m_read.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    //*** observers - approximate while the other thread is active ***
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return m_write.load(std::memory_order_acquire) -
+               m_read.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+    [[nodiscard]] size_type capacity() const noexcept { return Slots; }
+    [[nodiscard]] size_type max_size() const noexcept { return Slots; }
+
+private:
+    static constexpr size_type mask = Slots - 1;
+
+    T * slot(size_type index) noexcept
+    {
+#ifdef __cpp_lib_launder
+        return std::launder(reinterpret_cast<T *>(&m_storage[index & mask]));
+#else
+        return reinterpret_cast<T *>(&m_storage[index & mask]);
+#endif
+    }
+
+private:
+    slot_type   m_storage[Slots];
+    alignas(64) std::atomic<size_type> m_read{0};
+    alignas(64) std::atomic<size_type> m_write{0};
+};
+
+
+} // namespace datastructure
+
+#endif
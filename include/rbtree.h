@@ -3,11 +3,24 @@
 #ifndef DATASTRUCTURES_RBTREE_H
 #define DATASTRUCTURES_RBTREE_H
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define DATASTRUCTURES_PREFETCH(ptr) __builtin_prefetch(ptr)
+#   define DATASTRUCTURES_LIKELY(cond) __builtin_expect(!!(cond), 1)
+#   define DATASTRUCTURES_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#   define DATASTRUCTURES_PREFETCH(ptr) (static_cast<void>(0))
+#   define DATASTRUCTURES_LIKELY(cond) (cond)
+#   define DATASTRUCTURES_UNLIKELY(cond) (cond)
+#endif
 
 
 namespace datastructure {
@@ -19,203 +32,206 @@ namespace detail {
     //************************************************************************
     // Type-erased node manipulation
 
-    enum class Color : uint8_t { Red, Black };
+    enum class Color : std::uintptr_t { Red = 0, Black = 1 };
 
+    /// Node header. The color lives in the low bit of the parent pointer — nodes
+    /// are at least pointer-aligned, so the bit is free — keeping the header at
+    /// three pointers instead of three pointers plus a padded enum.
     struct NodeBase
     {
-        NodeBase *  parent = nullptr;
-        NodeBase *  left = nullptr;
-        NodeBase *  right = nullptr;
-        Color       color = Color::Red;
+        static constexpr std::uintptr_t colorMask = 0x1;
+
+        NodeBase *      left = nullptr;
+        NodeBase *      right = nullptr;
+        std::uintptr_t  parentColor = static_cast<std::uintptr_t>(Color::Red);
+
+        NodeBase * parent() const noexcept
+        {
+            return reinterpret_cast<NodeBase *>(parentColor & ~colorMask);
+        }
+        void setParent(NodeBase * node) noexcept
+        {
+            parentColor = reinterpret_cast<std::uintptr_t>(node) | (parentColor & colorMask);
+        }
+        Color color() const noexcept { return static_cast<Color>(parentColor & colorMask); }
+        void setColor(Color c) noexcept
+        {
+            parentColor = (parentColor & ~colorMask) | static_cast<std::uintptr_t>(c);
+        }
     };
+    static_assert(alignof(NodeBase) > 1, "low pointer bit must be free to hold the color");
 
     struct TreeBase
     {
-        NodeBase * nil = nullptr;     // owned
-        NodeBase * root = nullptr;    // owned, except if nil
+        NodeBase * nil = nullptr;       // owned
+        NodeBase * root = nullptr;      // owned, except if nil
+        NodeBase * leftmost = nullptr;  // cached begin(), nil when tree is empty
     };
 
-    inline bool isLeftChild(const NodeBase * node) { return node == node->parent->left; }
-    inline bool isRightChild(const NodeBase * node) { return node == node->parent->right; }
+    inline bool isLeftChild(const NodeBase * node) { return node == node->parent()->left; }
+    inline bool isRightChild(const NodeBase * node) { return node == node->parent()->right; }
     inline NodeBase * & linkTo(TreeBase & tree, NodeBase * node)
     {
-        if (isLeftChild(node)) { return node->parent->left; }
-        if (isRightChild(node)) { return node->parent->right; }
+        if (isLeftChild(node)) { return node->parent()->left; }
+        if (isRightChild(node)) { return node->parent()->right; }
         return tree.root;
     }
 
-    inline const NodeBase * allLeft(const NodeBase * node)
+    // NB below is NodeBase, possibly const-qualified, so a single definition
+    // serves both traversal constnesses without const_cast wrapper overloads
+
+    // Spine walks are fully serialized — each load depends on the previous
+    // one — so fetching one step ahead is all the overlap available
+
+    template <typename NB>
+    NB * allLeft(NB * node)
     {
-        while (node->left != node->left->left) { node = node->left; }
+        while (node->left != node->left->left) {
+            DATASTRUCTURES_PREFETCH(node->left->left);
+            node = node->left;
+        }
         return node;
     }
-    inline NodeBase * allLeft(NodeBase * node)
-    {
-        return const_cast<NodeBase *>(allLeft(const_cast<const NodeBase *>(node)));
-    }
 
-    inline const NodeBase * allRight(const NodeBase * node)
+    template <typename NB>
+    NB * allRight(NB * node)
     {
-        while (node->right != node->right->right) { node = node->right; }
+        while (node->right != node->right->right) {
+            DATASTRUCTURES_PREFETCH(node->right->right);
+            node = node->right;
+        }
         return node;
     }
-    inline NodeBase * allRight(NodeBase * node)
-    {
-        return const_cast<NodeBase *>(allRight(const_cast<const NodeBase *>(node)));
-    }
 
     /// In-order backwards traversal - return predecessor, or nullptr if none
-    inline const NodeBase * predecessor(const TreeBase & tree, const NodeBase * node)
+    template <typename NB>
+    NB * predecessor(const TreeBase & tree, NB * node)
     {
         if (node == tree.nil) { return allRight(tree.root); }
         if (node->left != tree.nil) { return allRight(node->left); }
         while (node != tree.nil) {
-            const auto * parent = node->parent;
+            auto * parent = node->parent();
             if (node == parent->right) { return parent; }
             node = parent;
         }
         return nullptr;
     }
-    inline NodeBase * predecessor(const TreeBase & tree, NodeBase * node)
-    {
-        return const_cast<NodeBase *>(predecessor(tree, const_cast<const NodeBase *>(node)));
-    }
 
     /// In-order forwards traversal - return successor, or nullptr if none
-    inline const NodeBase * successor(const TreeBase & tree, const NodeBase * node)
+    template <typename NB>
+    NB * successor(const TreeBase & tree, NB * node)
     {
         if (node == tree.nil) { return allLeft(tree.root); }
         if (node->right != tree.nil) { return allLeft(node->right); }
         while (node != tree.nil) {
-            const auto * parent = node->parent;
+            auto * parent = node->parent();
             if (node == parent->left) { return parent; }
             node = parent;
         }
         return nullptr;
     }
-    inline NodeBase * successor(const TreeBase & tree, NodeBase * node)
-    {
-        return const_cast<NodeBase *>(successor(tree, const_cast<const NodeBase *>(node)));
-    }
 
     inline void leftRotate(TreeBase & tree, NodeBase * x)
     {
         auto y = x->right;
         x->right = y->left;
-        x->right->parent = x;
+        x->right->setParent(x);
         y->left = x;
-        y->parent = x->parent;
+        y->setParent(x->parent());
         linkTo(tree, x) = y;
-        x->parent = y;
+        x->setParent(y);
     }
 
     inline void rightRotate(TreeBase & tree, NodeBase * y)
     {
         auto x = y->left;
         y->left = x->right;
-        y->left->parent = y;
+        y->left->setParent(y);
         x->right = y;
-        x->parent = y->parent;
+        x->setParent(y->parent());
         linkTo(tree, y) = x;
-        y->parent = x;
+        y->setParent(x);
     }
 
     inline void insertFixup(TreeBase & tree, NodeBase * node)
     {
         NodeBase * parent;
-        while(parent = node->parent, parent->color == Color::Red) {
-            auto uncle = isLeftChild(parent) ? parent->parent->right : parent->parent->left;
+        while(parent = node->parent(), parent->color() == Color::Red) {
+            auto uncle = isLeftChild(parent) ? parent->parent()->right : parent->parent()->left;
 
-            if (uncle->color == Color::Red) {
-                parent->color = Color::Black;
-                uncle->color = Color::Black;
-                parent->parent->color = Color::Red;
-                node = parent->parent;
+            // color flips dominate; rotations end the loop and are comparatively rare
+            if (DATASTRUCTURES_LIKELY(uncle->color() == Color::Red)) {
+                parent->setColor(Color::Black);
+                uncle->setColor(Color::Black);
+                parent->parent()->setColor(Color::Red);
+                node = parent->parent();
 
             } else {
                 if (isLeftChild(parent)) {
                     if (isRightChild(node)) {
                         node = parent;
                         leftRotate(tree, node);
-                        parent = node->parent;
+                        parent = node->parent();
                     }
-                    parent->color = Color::Black;
-                    parent->parent->color = Color::Red;
-                    rightRotate(tree, parent->parent);
+                    parent->setColor(Color::Black);
+                    parent->parent()->setColor(Color::Red);
+                    rightRotate(tree, parent->parent());
                 } else {
                     if (isLeftChild(node)) {
                         node = parent;
                         rightRotate(tree, node);
-                        parent = node->parent;
+                        parent = node->parent();
                     }
-                    parent->color = Color::Black;
-                    parent->parent->color = Color::Red;
-                    leftRotate(tree, parent->parent);
+                    parent->setColor(Color::Black);
+                    parent->parent()->setColor(Color::Red);
+                    leftRotate(tree, parent->parent());
                 }
                 // break; implied by loop condition
             }
         }
-        tree.root->color = Color::Black;
+        tree.root->setColor(Color::Black);
     }
 
     inline void extractFixup(TreeBase & tree, NodeBase * node)
     {
         NodeBase * parent;
-        while (parent = node->parent, node != tree.root && node->color == Color::Black)
+        while (parent = node->parent(), node != tree.root && node->color() == Color::Black)
         {
-            if (isLeftChild(node)) {
-                auto * sibling = parent->right;
-                if (sibling->color == Color::Red) {
-                    sibling->color = Color::Black;
-                    parent->color = Color::Red;
-                    leftRotate(tree, parent);
-                    sibling = parent->right;
-                }
-                if (sibling->left->color == Color::Black &&
-                    sibling->right->color == Color::Black) {
-                    sibling->color = Color::Red;
-                    node = parent;
-                } else {
-                    if (sibling->right->color == Color::Black) {
-                        sibling->left->color = Color::Black;
-                        sibling->color = Color::Red;
-                        rightRotate(tree, sibling);
-                        sibling = parent->right;
-                    }
-                    sibling->color = parent->color;
-                    parent->color = Color::Black;
-                    sibling->right->color = Color::Black;
-                    leftRotate(tree, parent);
-                    node = tree.root;
-                }
+            // The two handednesses mirror each other exactly; resolve the
+            // direction into child selectors and rotations once per level and
+            // write the case analysis a single time.
+            const bool onLeft = isLeftChild(node);
+            const auto near = onLeft ? &NodeBase::left : &NodeBase::right;
+            const auto far = onLeft ? &NodeBase::right : &NodeBase::left;
+            const auto rotateTowardNode = onLeft ? &leftRotate : &rightRotate;
+            const auto rotateAwayFromNode = onLeft ? &rightRotate : &leftRotate;
+
+            auto * sibling = parent->*far;
+            if (sibling->color() == Color::Red) {
+                sibling->setColor(Color::Black);
+                parent->setColor(Color::Red);
+                rotateTowardNode(tree, parent);
+                sibling = parent->*far;
+            }
+            if (DATASTRUCTURES_LIKELY((sibling->*near)->color() == Color::Black &&
+                                      (sibling->*far)->color() == Color::Black)) {
+                sibling->setColor(Color::Red);
+                node = parent;
             } else {
-                auto * sibling = parent->left;
-                if (sibling->color == Color::Red) {
-                    sibling->color = Color::Black;
-                    parent->color = Color::Red;
-                    rightRotate(tree, parent);
-                    sibling = parent->left;
-                }
-                if (sibling->right->color == Color::Black &&
-                    sibling->left->color == Color::Black) {
-                    sibling->color = Color::Red;
-                    node = parent;
-                } else {
-                    if (sibling->left->color == Color::Black) {
-                        sibling->right->color = Color::Black;
-                        sibling->color = Color::Red;
-                        leftRotate(tree, sibling);
-                        sibling = parent->left;
-                    }
-                    sibling->color = parent->color;
-                    parent->color = Color::Black;
-                    sibling->left->color = Color::Black;
-                    rightRotate(tree, parent);
-                    node = tree.root;
+                if ((sibling->*far)->color() == Color::Black) {
+                    (sibling->*near)->setColor(Color::Black);
+                    sibling->setColor(Color::Red);
+                    rotateAwayFromNode(tree, sibling);
+                    sibling = parent->*far;
                 }
+                sibling->setColor(parent->color());
+                parent->setColor(Color::Black);
+                (sibling->*far)->setColor(Color::Black);
+                rotateTowardNode(tree, parent);
+                node = tree.root;
             }
         }
-        node->color = Color::Black;
+        node->setColor(Color::Black);
     }
 
     inline void extractNode(TreeBase & tree, NodeBase * node)
@@ -225,32 +241,36 @@ namespace detail {
 
         if (node->left != tree.nil && node->right != tree.nil) {
             replacement = allLeft(node->right);
+            // both lines are needed for the relink below, get them in flight together
+            DATASTRUCTURES_PREFETCH(replacement->right);
+            DATASTRUCTURES_PREFETCH(replacement->parent());
 
             if (replacement == node->right) { // replacement is immediate right child
                 node->right = replacement->right;
-                node->right->parent = node;
+                node->right->setParent(node);
             } else {                        // replacement is deep
-                replacement->parent->left = replacement->right;
-                replacement->parent->left->parent = replacement->parent;
+                replacement->parent()->left = replacement->right;
+                replacement->parent()->left->setParent(replacement->parent());
             }
-            fixupRoot = replacement->color == Color::Black ? replacement->right : nullptr;
+            fixupRoot = replacement->color() == Color::Black ? replacement->right : nullptr;
+            replacement->setColor(node->color());   // take over node's place and color
             replacement->left = node->left;
             replacement->right = node->right;
-            replacement->left->parent = replacement->right->parent = replacement;
+            replacement->left->setParent(replacement);
+            replacement->right->setParent(replacement);
 
         } else if (node->left != tree.nil) {        // no right child
             replacement = fixupRoot = node->left;
-            fixupRoot = node->color == Color::Black ? replacement : nullptr;
+            fixupRoot = node->color() == Color::Black ? replacement : nullptr;
         } else if (node->right != tree.nil) {       // no left child
             replacement = node->right;
-            fixupRoot = node->color == Color::Black ? replacement : nullptr;
+            fixupRoot = node->color() == Color::Black ? replacement : nullptr;
         } else {
-            fixupRoot = node->color == Color::Black ? replacement : nullptr;
+            fixupRoot = node->color() == Color::Black ? replacement : nullptr;
         }
 
         linkTo(tree, node) = replacement;
-        replacement->parent = node->parent;
-        replacement->color = node->color;
+        replacement->setParent(node->parent());
 
         if (fixupRoot) { extractFixup(tree, fixupRoot); }
     }
@@ -261,38 +281,63 @@ namespace detail {
     template <typename K, typename T>
     struct Node final : public NodeBase
     {
-        std::pair<const K, T>   value;
+        std::pair<const K, T>   value;  ///< leads with the key, right after the links,
+                                        ///< so descents never leave the node's cache line
 
         Node(const K & k) : value(k, T{}) {}
         Node(K && k) : value(std::move(k), T{}) {}
         Node(const std::pair<const K, T> & v) : value(v) {}
         Node(std::pair<const K, T> && v) : value(std::move(v)) {}
+
+        const K & key() const noexcept { return value.first; }
     };
 
-    /// Find node of a given key, looking from a given root, returning possible insertion point if not found
+    template <typename N>
+    struct FindResult
+    {
+        N *     node;   ///< matching node if side is 0, insertion-point leaf otherwise
+        int     side;   ///< <0: key goes left of node, >0: right of node, 0: exact match
+    };
+
+    /// Find node of a given key, looking from a given root, returning possible insertion point if not found.
+    /// The descent makes a single comparator call per node and selects the next
+    /// child without branching on the result, so the next node's load can issue
+    /// while the comparison is still in flight. Equality is resolved once after
+    /// the walk, against the last node whose key was not greater than the target.
+    /// The final comparison outcome is returned along with the node, so callers
+    /// attaching a new node need not re-compare to pick a side.
     template <typename K, typename T, typename Compare>
-    const Node<K, T> * findNode(const TreeBase & tree, const K & key, const Compare & cmp)
+    FindResult<const Node<K, T>> findNode(const TreeBase & tree, const K & key, const Compare & cmp)
     {
         using N = const Node<K, T>;
         const NodeBase * node = tree.root;
         const NodeBase * next = node;
+        const NodeBase * candidate = nullptr;
+        bool less = false;
         while (next != tree.nil) {
             node = next;
-            if (cmp(key, static_cast<N *>(node)->value.first)) {
-                next = node->left;
-            } else if (cmp(static_cast<N *>(node)->value.first, key)) {
-                next = node->right;
+            // start fetching the next level while the comparison runs, whichever way it goes
+            DATASTRUCTURES_PREFETCH(node->left);
+            DATASTRUCTURES_PREFETCH(node->right);
+            if constexpr (std::is_same_v<Compare, std::less<K>> && std::is_arithmetic_v<K>) {
+                // hardwired compare: the whole step is one cmp plus two cmov
+                less = key < static_cast<N *>(node)->key();
             } else {
-                next = tree.nil;
+                less = cmp(key, static_cast<N *>(node)->key());
             }
+            candidate = less ? candidate : node;
+            next = less ? node->left : node->right;
+        }
+        if (candidate && !cmp(static_cast<N *>(candidate)->key(), key)) {
+            return {static_cast<N *>(candidate), 0};
         }
-        return static_cast<N *>(node);
+        return {static_cast<N *>(node), less ? -1 : 1};
     }
     template <typename K, typename T, typename Compare>
-    Node<K, T> * findNode(TreeBase & tree, const K & key, const Compare & cmp)
+    FindResult<Node<K, T>> findNode(TreeBase & tree, const K & key, const Compare & cmp)
     {
-        using N = Node<K, T>;
-        return const_cast<N *>(findNode<K, T, Compare>(const_cast<const TreeBase &>(tree), key, cmp));
+        auto found = findNode<K, T, Compare>(const_cast<const TreeBase &>(tree), key, cmp);
+        return {const_cast<Node<K, T> *>(found.node), found.side};
     }
 
     //************************************************************************
@@ -320,7 +365,8 @@ namespace detail {
             auto * storage = std::allocator_traits<NodeAllocator>::allocate(this->allocator(), 1);
             nil = new (storage) NodeBase;
             nil->left = nil->right = nil;
-            nil->color = Color::Black;
+            nil->setColor(Color::Black);
+            leftmost = nil;
             return nil;
         }
 
@@ -345,6 +391,7 @@ namespace detail {
     protected:
         using tree_type = std::conditional_t<Const, const TreeBase, TreeBase>;
         using node_type = std::conditional_t<Const, const Node<K, T>, Node<K, T>>;
+        using base_type = std::conditional_t<Const, const NodeBase, NodeBase>;
     public:
         using iterator_category = std::bidirectional_iterator_tag;
         using value_type = std::conditional_t<Const, const decltype(node_type::value), decltype(node_type::value)>;
@@ -362,14 +409,14 @@ namespace detail {
 
         IteratorTemplate & operator++()
         {
-            m_node = static_cast<node_type *>(successor(*m_tree, m_node));
+            m_node = static_cast<node_type *>(successor(*m_tree, static_cast<base_type *>(m_node)));
             return *this;
         }
         const IteratorTemplate operator++(int) const { return IteratorTemplate(successor(*m_tree, m_node)); }
 
         IteratorTemplate & operator--()
         {
-            m_node = static_cast<node_type *>(predecessor(*m_tree, m_node));
+            m_node = static_cast<node_type *>(predecessor(*m_tree, static_cast<base_type *>(m_node)));
             return *this;
         }
         const IteratorTemplate operator--(int) const { return IteratorTemplate(predecessor(*m_tree, m_node)); }
@@ -438,14 +485,14 @@ public:
               NodeAllocatorTraits::select_on_container_copy_construction(other.m_data.allocator()))
     {
         m_data.root = m_data.createNil();
-        this->insert(other.begin(), other.end());
+        this->assign_sorted(other.begin(), other.end());    // iteration order is sorted already
     }
 
     RBTree(const RBTree & other, const Allocator & alloc)
      : m_data(other.m_data.comparator(), alloc)
     {
         m_data.root = m_data.createNil();
-        this->insert(other.begin(), other.end());
+        this->assign_sorted(other.begin(), other.end());
     }
 
     RBTree(RBTree && other) noexcept
@@ -455,6 +502,7 @@ public:
         using std::swap;
         swap(m_data.nil, other.m_data.nil);
         swap(m_data.root, other.m_data.root);
+        swap(m_data.leftmost, other.m_data.leftmost);
         swap(m_size, other.m_size);
     }
 
@@ -465,11 +513,12 @@ public:
         if (alloc == other.m_data.allocator()) {
             swap(m_data.nil, other.m_data.nil);
             swap(m_data.root, other.m_data.root);
+            swap(m_data.leftmost, other.m_data.leftmost);
             swap(m_size, other.m_size);
         } else {
             m_data.root = m_data.createNil();
-            this->insert(std::make_move_iterator(other.begin()),
-                         std::make_move_iterator(other.end()));
+            this->assign_sorted(std::make_move_iterator(other.begin()),
+                                std::make_move_iterator(other.end()));
         }
     }
 
@@ -479,6 +528,17 @@ public:
      : m_data(comp, alloc)
     {
         m_data.root = m_data.createNil();
+        using category = typename std::iterator_traits<Iterator>::iterator_category;
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            // an already-sorted duplicate-free range builds in O(n), no rebalancing
+            auto misordered = [&comp](const value_type & lhs, const value_type & rhs) {
+                return !comp(lhs.first, rhs.first);
+            };
+            if (std::adjacent_find(from, to, misordered) == to) {
+                this->assign_sorted(from, to);
+                return;
+            }
+        }
         this->insert(from, to);
     }
 
@@ -505,7 +565,7 @@ public:
             m_data.allocator() = rhs.m_data.allocator();
             m_data.root = m_data.createNil();
         }
-        this->insert(rhs.begin(), rhs.end());   //TODO bisect-based construction
+        this->assign_sorted(rhs.begin(), rhs.end());    // iteration order is sorted already
         return *this;
     }
 
@@ -520,6 +580,7 @@ public:
         }
         swap(m_data.nil, rhs.m_data.nil);
         swap(m_data.root, rhs.m_data.root);
+        swap(m_data.leftmost, rhs.m_data.leftmost);
         swap(m_size, rhs.m_size);
         return *this;
     }
@@ -534,70 +595,74 @@ public:
 
     const_reference at(const K & key) const
     {
-        auto * node = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
-        if (node != m_data.nil && key == node->value.first) { return node->value.second; }
+        auto found = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
+        if (found.side == 0) { return found.node->value.second; }
         throw std::out_of_range("key does not exist");
     }
 
     reference operator[](const K & key)
     {
-        auto * node = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
-        if (node != m_data.nil && key == node->value.first) { return node->value.second; }
-
-        auto * newNode = buildNode(key);
-        newNode->parent = node;
-        if (node == m_data.nil) {
-            m_data.root = newNode;
-        } else {
-            if (m_data.comparator()(newNode->value.first, node->value.first)) {
-                node->left = newNode;
-            } else {
-                node->right = newNode;
-            }
-        }
-        insertFixup(m_data, newNode);
-        m_size += 1;
-        return newNode->value.second;
+        auto found = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
+        if (found.side == 0) { return found.node->value.second; }
+        return attachNode(buildNode(key), found)->value.second;
     }
 
     reference operator[](K && key)
     {
-        auto * node = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
-        if (node != m_data.nil && key == node->value.first) { return node->value.second; }
-
-        auto * newNode = buildNode(std::move(key));
-        newNode->parent = node;
-        if (node == m_data.nil) {
-            m_data.root = newNode;
-        } else {
-            if (m_data.comparator()(newNode->value.first, node->value.first)) {
-                node->left = newNode;
-            } else {
-                node->right = newNode;
-            }
-        }
-        insertFixup(m_data, newNode);
-        m_size += 1;
-        return newNode->value.second;
+        auto found = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
+        if (found.side == 0) { return found.node->value.second; }
+        return attachNode(buildNode(std::move(key)), found)->value.second;
     }
 
     void clear()
     {
-        auto * node = allLeft(m_data.root);
-        while (node != m_data.nil) {
-            while (node->right != m_data.nil) { node = allLeft(node->right); }
-
-            detail::NodeBase * leaf;
-            do {
-                leaf = node;
-                node = node->parent;
-                destroyNode(static_cast<Node *>(leaf));
-            } while (leaf == node->right);
+        // Destroy in preorder with an explicit stack instead of climbing parent
+        // pointers: child links were just loaded, parent lines may be long
+        // evicted. Red-black height is bounded by 2·log2(n+1) and max_size
+        // caps n well below 2^60, so 128 entries always suffice.
+        detail::NodeBase * stack[128];
+        unsigned depth = 0;
+        if (m_data.root != m_data.nil) { stack[depth++] = m_data.root; }
+        while (depth > 0) {
+            auto * node = stack[--depth];
+            if (node->left != m_data.nil) { stack[depth++] = node->left; }
+            if (node->right != m_data.nil) { stack[depth++] = node->right; }
+            destroyNode(static_cast<Node *>(node));
         }
         m_data.root = m_data.nil;
+        m_data.leftmost = m_data.nil;
         m_size = 0;
     }
 
+    /// Rebuild the tree into freshly allocated nodes, perfectly balanced and laid
+    /// out in key order. After many scattered insertions and deletions this
+    /// restores allocation locality — consecutive lookups and range scans touch
+    /// neighbouring memory again. Invalidates all iterators.
+    void compact()
+    {
+        if (m_size == 0) { return; }
+
+        auto old = std::vector<Node *>();
+        old.reserve(m_size);
+        for (auto * node = allLeft(m_data.root); node; node = successor(m_data, node)) {
+            old.push_back(static_cast<Node *>(node));
+        }
+
+        auto fresh = std::vector<Node *>();
+        fresh.reserve(old.size());
+        try {
+            for (auto * node : old) { fresh.push_back(buildNode(std::move(node->value))); }
+        } catch (...) {
+            for (auto * node : fresh) { destroyNode(node); }
+            throw;      // old nodes keep their moved-from values; tree stays valid
+        }
+        for (auto * node : old) { destroyNode(node); }
+
+        m_data.root = linkRange(fresh.data(), fresh.size(), m_data.nil, 0, bottomDepth(fresh.size()));
+        m_data.root->setColor(detail::Color::Black);
+        m_data.leftmost = fresh.front();
+    }
+
     std::pair<iterator, bool> insert(const value_type & value)
     {
         return this->insert(value_type(value));
@@ -605,22 +670,11 @@ public:
 
     std::pair<iterator, bool> insert(value_type && value)
     {
-        auto * node = detail::findNode<K, T, Compare>(m_data, value.first, m_data.comparator());
-        if (node != m_data.nil && value.first == node->value.first) {
-            return {iterator(m_data, node), false};
-        }
-
-        auto * newNode = buildNode(std::forward<value_type>(value));
-        newNode->parent = node;
-        if (node == m_data.nil) {
-            m_data.root = newNode;
-        } else {
-            if (m_data.comparator()(value.first, node->value.first)) { node->left = newNode; }
-                                                                else { node->right = newNode; }
+        auto found = detail::findNode<K, T, Compare>(m_data, value.first, m_data.comparator());
+        if (found.side == 0) {
+            return {iterator(m_data, found.node), false};
         }
-        insertFixup(m_data, newNode);
-        m_size += 1;
-        return {iterator(m_data, newNode), true};
+        return {iterator(m_data, attachNode(buildNode(std::forward<value_type>(value)), found)), true};
     }
 
     void insert(std::initializer_list<value_type> values)
@@ -636,9 +690,31 @@ public:
         }
     }
 
+    /// Replace the contents with a range already sorted by the tree's comparator,
+    /// holding no equivalent keys. Builds a perfectly balanced tree in O(n),
+    /// with no comparisons and no rebalancing.
+    template<typename Iterator> void assign_sorted(Iterator first, Iterator last)
+    {
+        this->clear();
+        auto fresh = std::vector<Node *>();
+        try {
+            for (; first != last; ++first) { fresh.push_back(buildNode(*first)); }
+        } catch (...) {
+            for (auto * node : fresh) { destroyNode(node); }
+            throw;
+        }
+        if (!fresh.empty()) {
+            m_data.root = linkRange(fresh.data(), fresh.size(), m_data.nil, 0, bottomDepth(fresh.size()));
+            m_data.root->setColor(detail::Color::Black);
+            m_data.leftmost = fresh.front();
+        }
+        m_size = fresh.size();
+    }
+
     void erase(iterator it)
     {
         auto * node = it._node();
+        advanceLeftmost(node);
         extractNode(m_data, node);
         destroyNode(node);
         m_size -= 1;
@@ -647,6 +723,7 @@ public:
     void erase(const_iterator it)
     {
         auto * node = const_cast<Node *>(it._node());
+        advanceLeftmost(node);
         extractNode(m_data, node);
         destroyNode(node);
         m_size -= 1;
@@ -666,20 +743,19 @@ public:
 
     [[nodiscard]] const_iterator find(const K & key) const
     {
-        if (m_data.root == m_data.nil) { return const_iterator(); }
-        auto * node = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
-        if (node == m_data.nil || key != node->value.first) { return const_iterator(m_data, nullptr); }
-        return const_iterator(m_data, node);
+        auto found = detail::findNode<K, T, Compare>(m_data, key, m_data.comparator());
+        if (found.side != 0) { return const_iterator(m_data, nullptr); }
+        return const_iterator(m_data, found.node);
     }
 
     [[nodiscard]] iterator begin() {
-        return iterator(m_data, static_cast<Node *>(allLeft(m_data.root)));
+        return iterator(m_data, static_cast<Node *>(m_data.leftmost));
     }
     [[nodiscard]] const_iterator begin() const {
-        return const_iterator(m_data, static_cast<const Node *>(allLeft(m_data.root)));
+        return const_iterator(m_data, static_cast<const Node *>(m_data.leftmost));
     }
     [[nodiscard]] const_iterator cbegin() const {
-        return const_iterator(m_data, static_cast<const Node *>(allLeft(m_data.root)));
+        return const_iterator(m_data, static_cast<const Node *>(m_data.leftmost));
     }
     [[nodiscard]] iterator end() { return iterator(m_data, nullptr); }
     [[nodiscard]] const_iterator end() const { return const_iterator(m_data, nullptr); }
@@ -696,6 +772,7 @@ public:
         swap(m_data.comparator(), rhs.m_data.comparator());
         swap(m_data.nil, rhs.m_data.nil);
         swap(m_data.root, rhs.m_data.root);
+        swap(m_data.leftmost, rhs.m_data.leftmost);
         swap(m_size, rhs.m_size);
     }
 
@@ -716,9 +793,36 @@ public:
 
     friend bool operator==(const RBTree & lhs, const RBTree & rhs)
     {
-        return lhs.m_data.allocator() == rhs.m_data.allocator() &&
-            lhs.m_size == rhs.m_size &&
-            std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+        if (lhs.m_data.allocator() != rhs.m_data.allocator() ||
+            lhs.m_size != rhs.m_size) { return false; }
+
+        // Equal-content trees may still differ in shape, so walk both in-order —
+        // but with explicit stacks of just-visited ancestors rather than iterator
+        // successor calls, which re-climb cold parent lines at every step.
+        // See clear() for the 128-entry depth bound.
+        struct Walk
+        {
+            const detail::TreeBase &    tree;
+            const detail::NodeBase *    next;
+            const detail::NodeBase *    stack[128];
+            unsigned                    depth = 0;
+
+            explicit Walk(const detail::TreeBase & t) : tree(t), next(t.root) {}
+            const Node * advance()
+            {
+                while (next != tree.nil) { stack[depth++] = next; next = next->left; }
+                if (depth == 0) { return nullptr; }
+                auto * visited = stack[--depth];
+                next = visited->right;
+                return static_cast<const Node *>(visited);
+            }
+        };
+        auto left = Walk(lhs.m_data);
+        auto right = Walk(rhs.m_data);
+        for (size_type i = 0; i < lhs.m_size; ++i) {
+            if (left.advance()->value != right.advance()->value) { return false; }
+        }
+        return true;
     }
 
     friend bool operator!=(const RBTree & lhs, const RBTree & rhs) { return !(lhs == rhs); }
@@ -729,23 +833,82 @@ private:
     {
         Node * node;
         auto * storage = NodeAllocatorTraits::allocate(m_data.allocator(), 1);
-        try {
+        if constexpr (std::is_nothrow_constructible_v<Node, Args &&...>) {
+            // no cleanup to arrange for — keeps the hot path inlinable
             node = new (storage) Node(std::forward<Args>(args)...);
-        } catch (...) {
-            NodeAllocatorTraits::deallocate(m_data.allocator(), storage, 1);
-            throw;
+        } else {
+            try {
+                node = new (storage) Node(std::forward<Args>(args)...);
+            } catch (...) {
+                NodeAllocatorTraits::deallocate(m_data.allocator(), storage, 1);
+                throw;
+            }
         }
         node->left = node->right = m_data.nil;
         return node;
     }
 
+    /// Attach a fresh node at the insertion point a findNode descent returned,
+    /// reusing its final comparison rather than comparing again.
+    Node * attachNode(Node * newNode, detail::FindResult<Node> where)
+    {
+        newNode->setParent(where.node);
+        if (where.node == m_data.nil) {
+            m_data.root = newNode;
+            m_data.leftmost = newNode;
+        } else if (where.side < 0) {
+            where.node->left = newNode;
+            // a left child of the leftmost node is the new leftmost
+            if (where.node == m_data.leftmost) { m_data.leftmost = newNode; }
+        } else {
+            where.node->right = newNode;
+        }
+        insertFixup(m_data, newNode);
+        m_size += 1;
+        return newNode;
+    }
+
+    /// Keep the cached leftmost valid across the removal of node
+    void advanceLeftmost(detail::NodeBase * node) noexcept
+    {
+        if (node != m_data.leftmost) { return; }
+        // the leftmost node has no left child: its successor is up or right
+        auto * next = successor(m_data, node);
+        m_data.leftmost = next ? next : m_data.nil;
+    }
+
     void destroyNode(Node * node)
     {
         node->~Node();
         NodeAllocatorTraits::deallocate(m_data.allocator(), node, 1);
     }
 
+    /// Depth of the deepest level when count nodes are split by midpoint
+    static unsigned bottomDepth(size_type count) noexcept
+    {
+        unsigned depth = 0;
+        for (; count > 1; count >>= 1) { depth += 1; }
+        return depth;
+    }
+
+    /// Link sorted nodes into a perfectly balanced subtree. Nodes above the
+    /// deepest level are black, the deepest level is red, which satisfies the
+    /// red-black invariants since leaves end up on the last two levels only.
+    detail::NodeBase * linkRange(Node * const * nodes, size_type count,
+                                 detail::NodeBase * parent, unsigned depth, unsigned redDepth)
+    {
+        if (count == 0) { return m_data.nil; }
+        auto mid = count / 2;
+        auto * node = nodes[mid];
+        node->setParent(parent);
+        node->setColor(depth == redDepth ? detail::Color::Red : detail::Color::Black);
+        node->left = linkRange(nodes, mid, node, depth + 1, redDepth);
+        node->right = linkRange(nodes + mid + 1, count - mid - 1, node, depth + 1, redDepth);
+        return node;
+    }
+
     friend auto detail::root<RBTree>(const RBTree &); // used by rbtree_tools to access internals
+    friend auto detail::nil<RBTree>(const RBTree &);
 
 private:
     Data        m_data;
@@ -4,8 +4,9 @@
 #define DATASTRUCTURES_RBTREE_TOOLS_H
 
 #include <ostream>
-#include <queue>
 #include <string>
+#include <vector>
+#include "rbtree.h"
 
 namespace datastructure::tools {
 
@@ -17,31 +18,34 @@ namespace datastructure::tools {
         using Tree = RBTree<K, T, Compare, Allocator>;
         using Node = detail::Node<typename Tree::key_type, typename Tree::mapped_type>;
 
-        std::queue<NodeBase *> todo;
-        todo.push(detail::root(tree));
+        const NodeBase * nil = detail::nil(tree);
+
+        auto stack = std::vector<const NodeBase *>();
+        stack.reserve(64);      // twice the height bound of any practical tree
+        if (detail::root(tree) != nil) { stack.push_back(detail::root(tree)); }
 
         out <<"digraph \"" <<name <<"\" {\n";
 
-        while (!todo.empty()) {
-            auto node = static_cast<Node *>(todo.front());
+        while (!stack.empty()) {
+            auto node = static_cast<const Node *>(stack.back());
+            stack.pop_back();
             out <<"    \"" <<node
-                <<"\" [color=" <<(node->color == detail::Color::Red ? "red" : "black")
+                <<"\" [color=" <<(node->color() == detail::Color::Red ? "red" : "black")
                 <<" label=<"
                 <<node->value.first
                 <<"<BR/><FONT POINT-SIZE=\"10\">"
                 <<node->value.second
                 <<"</FONT>>];\n";
-            if (node->left != detail::nil) {
+            if (node->left != nil) {
                 out <<"    \"" <<node
-                    <<"\" -> \"" <<static_cast<Node *>(node->left) <<"\";\n";
+                    <<"\" -> \"" <<static_cast<const Node *>(node->left) <<"\";\n";
+                stack.push_back(node->left);
             }
-            if (node->right != detail::nil) {
+            if (node->right != nil) {
                 out <<"    \"" <<node
-                    <<"\" -> \"" <<static_cast<Node *>(node->right) <<"\";\n";
+                    <<"\" -> \"" <<static_cast<const Node *>(node->right) <<"\";\n";
+                stack.push_back(node->right);
             }
-            if (node->left != datastructure::detail::nil) { todo.push(node->left); }
-            if (node->right != datastructure::detail::nil) { todo.push(node->right); }
-            todo.pop();
         }
         out <<"}\n";
     }
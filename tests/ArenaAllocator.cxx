@@ -0,0 +1,92 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "ArenaAllocator.h"
+#include "rbtree.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+
+using datastructure::ArenaAllocator;
+
+TEST(ArenaAllocator, requirements)
+{
+    using type = ArenaAllocator<int>;
+
+    static_assert(std::is_same_v<type::value_type, int>);
+    static_assert(std::is_default_constructible_v<type>);
+    static_assert(std::is_copy_constructible_v<type>);
+    static_assert(std::is_constructible_v<ArenaAllocator<long>, const type &>);
+
+    SUCCEED();
+}
+
+TEST(ArenaAllocator, packs_sequential_allocations)
+{
+    auto alloc = ArenaAllocator<std::uint64_t>();
+
+    auto * first = alloc.allocate(1);
+    auto * second = alloc.allocate(1);
+    EXPECT_LT(reinterpret_cast<char *>(first), reinterpret_cast<char *>(second));
+    EXPECT_LE(reinterpret_cast<char *>(second) - reinterpret_cast<char *>(first),
+              std::ptrdiff_t(64));
+
+    alloc.deallocate(second, 1);
+    alloc.deallocate(first, 1);
+}
+
+TEST(ArenaAllocator, recycles_freed_blocks)
+{
+    auto alloc = ArenaAllocator<std::uint64_t>();
+
+    auto * first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    auto * second = alloc.allocate(1);
+    EXPECT_EQ(first, second);
+    alloc.deallocate(second, 1);
+}
+
+TEST(ArenaAllocator, copies_share_the_arena)
+{
+    auto alloc = ArenaAllocator<std::uint64_t>();
+    auto copy = alloc;
+    EXPECT_EQ(alloc, copy);
+
+    auto * block = alloc.allocate(1);
+    copy.deallocate(block, 1);      // must be valid on any equal copy
+    EXPECT_EQ(copy.allocate(1), block);
+
+    auto other = ArenaAllocator<std::uint64_t>();
+    EXPECT_NE(alloc, other);
+}
+
+TEST(ArenaAllocator, backs_a_tree)
+{
+    auto alloc = ArenaAllocator<std::pair<const int, int>>();
+    auto tree = datastructure::RBTree<int, int, std::less<int>,
+                                      decltype(alloc)>(alloc);
+
+    for (int i = 0; i < 1000; ++i) { tree[i] = i * 2; }
+    for (int i = 0; i < 1000; i += 2) { tree.erase(i); }
+    for (int i = 1; i < 1000; i += 2) { EXPECT_EQ(tree.at(i), i * 2); }
+    EXPECT_EQ(tree.size(), 500u);
+
+    // nodes allocated back to back share cache lines: consecutive keys
+    // inserted in order should sit close together in memory
+    auto first = tree.find(501);
+    auto second = tree.find(503);
+    auto distance = reinterpret_cast<const char *>(&second->first)
+                  - reinterpret_cast<const char *>(&first->first);
+    EXPECT_LT(distance < 0 ? -distance : distance, std::ptrdiff_t(4096));
+}
+
+TEST(ArenaAllocator, release_reuses_chunks)
+{
+    auto alloc = ArenaAllocator<std::uint64_t>();
+
+    auto * first = alloc.allocate(1);
+    // spill into more chunks; the blocks are reclaimed wholesale by release()
+    for (int i = 0; i < 1000; ++i) { static_cast<void>(alloc.allocate(1)); }
+
+    alloc.release();
+    EXPECT_EQ(alloc.allocate(1), first);    // bump pointer restarted on chunk one
+}
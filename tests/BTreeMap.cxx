@@ -0,0 +1,129 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "BTreeMap.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+
+TEST(BTreeMap, requirements)
+{
+    using BTreeMap = typename datastructure::BTreeMap<int, std::string>;
+
+    static_assert(std::is_default_constructible_v<BTreeMap>);
+    static_assert(std::is_copy_constructible_v<BTreeMap>);
+    static_assert(std::is_move_constructible_v<BTreeMap>);
+    static_assert(std::is_same_v<int, typename BTreeMap::key_type>);
+    static_assert(std::is_same_v<std::string, typename BTreeMap::mapped_type>);
+
+    SUCCEED();
+}
+
+TEST(BTreeMap, basic_operations)
+{
+    auto map = datastructure::BTreeMap<int, std::string>();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_THROW(map.at(1), std::out_of_range);
+
+    map[1] = "one";
+    map[3] = "three";
+    map[2] = "two";
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.at(2), "two");
+    EXPECT_EQ(map[3], "three");
+
+    auto [it, inserted] = map.insert({4, "four"});
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, 4);
+    std::tie(it, inserted) = map.insert({4, "again"});
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(map.at(4), "four");
+
+    int expected = 1;
+    for (auto entry : map) {
+        EXPECT_EQ(entry.first, expected);
+        expected += 1;
+    }
+    EXPECT_EQ(expected, 5);
+
+    map.erase(3);
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.find(3), map.end());
+    map.erase(3);                       // absent: no effect
+    EXPECT_EQ(map.size(), 3u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(BTreeMap, node_splits_and_merges)
+{
+    // enough entries for several levels, erased in a pattern that exercises
+    // borrow-from-left, borrow-from-right and merges on the way down
+    auto map = datastructure::BTreeMap<int, int>();
+    for (int i = 0; i < 2000; ++i) { map[i] = i * 7; }
+    EXPECT_EQ(map.size(), 2000u);
+
+    for (int i = 0; i < 2000; i += 3) { map.erase(i); }
+    for (int i = 1999; i >= 1000; i -= 5) { map.erase(i); }
+
+    auto model = std::map<int, int>();
+    for (int i = 0; i < 2000; ++i) { model[i] = i * 7; }
+    for (int i = 0; i < 2000; i += 3) { model.erase(i); }
+    for (int i = 1999; i >= 1000; i -= 5) { model.erase(i); }
+
+    EXPECT_EQ(map.size(), model.size());
+    auto it = model.begin();
+    for (auto entry : map) {
+        EXPECT_EQ(entry.first, it->first);
+        EXPECT_EQ(entry.second, it->second);
+        ++it;
+    }
+}
+
+TEST(BTreeMap, randomized_against_map)
+{
+    auto rng = std::mt19937(12345);
+    auto map = datastructure::BTreeMap<int, int>();
+    auto model = std::map<int, int>();
+
+    for (int op = 0; op < 50000; ++op) {
+        int key = int(rng() % 800);
+        if (rng() % 3 != 0) {
+            map[key] = op;
+            model[key] = op;
+        } else {
+            map.erase(key);
+            model.erase(key);
+        }
+    }
+
+    EXPECT_EQ(map.size(), model.size());
+    auto it = model.begin();
+    for (auto entry : map) {
+        ASSERT_EQ(entry.first, it->first);
+        ASSERT_EQ(entry.second, it->second);
+        ++it;
+    }
+    EXPECT_EQ(it, model.end());
+}
+
+TEST(BTreeMap, string_keys)
+{
+    // non-trivial keys exercise the placement-new entry moves in splits and merges
+    auto map = datastructure::BTreeMap<std::string, int>();
+    for (int i = 0; i < 500; ++i) { map["key-" + std::to_string(i)] = i; }
+    EXPECT_EQ(map.size(), 500u);
+
+    for (int i = 0; i < 500; i += 2) { map.erase("key-" + std::to_string(i)); }
+    EXPECT_EQ(map.size(), 250u);
+    for (int i = 1; i < 500; i += 2) { EXPECT_EQ(map.at("key-" + std::to_string(i)), i); }
+
+    auto copy = map;
+    EXPECT_EQ(copy, map);
+    copy.erase("key-1");
+    EXPECT_NE(copy, map);
+}
@@ -0,0 +1,92 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "FrozenTree.h"
+
+#include "rbtree.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using datastructure::FrozenTree;
+using datastructure::RBTree;
+
+TEST(FrozenTree, requirements)
+{
+    using type = FrozenTree<int, std::string>;
+
+    static_assert(std::is_same_v<type::key_type, int>);
+    static_assert(std::is_same_v<type::mapped_type, std::string>);
+    static_assert(std::is_same_v<type::key_compare, std::less<int>>);
+    static_assert(std::is_default_constructible_v<type>);
+    static_assert(std::is_copy_constructible_v<type>);
+    static_assert(std::is_move_constructible_v<type>);
+
+    SUCCEED();
+}
+
+TEST(FrozenTree, empty)
+{
+    auto frozen = FrozenTree<int, std::string>();
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(frozen.size(), 0);
+    EXPECT_FALSE(frozen.contains(0));
+    EXPECT_THROW(frozen.at(0), std::out_of_range);
+}
+
+TEST(FrozenTree, freeze_rbtree)
+{
+    auto tree = RBTree<int, std::string>();
+    for (int i = 0; i < 100; ++i) { tree[2 * i] = std::to_string(2 * i); }
+
+    auto frozen = datastructure::freeze(tree);
+    EXPECT_EQ(frozen.size(), tree.size());
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(frozen.contains(2 * i));
+        EXPECT_EQ(frozen.at(2 * i), std::to_string(2 * i));
+        EXPECT_FALSE(frozen.contains(2 * i + 1));
+    }
+    EXPECT_FALSE(frozen.contains(-1));
+    EXPECT_EQ(frozen.find(1), nullptr);
+    EXPECT_THROW(frozen.at(1), std::out_of_range);
+}
+
+TEST(FrozenTree, custom_comparator)
+{
+    auto tree = RBTree<int, std::string, std::greater<int>>({
+        {1, "1"}, {2, "2"}, {3, "3"}, {4, "4"}, {5, "5"}
+    });
+
+    auto frozen = datastructure::freeze(tree);
+    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(frozen.at(i), std::to_string(i)); }
+    EXPECT_FALSE(frozen.contains(0));
+    EXPECT_FALSE(frozen.contains(6));
+}
+
+TEST(FrozenTree, lookup_parity_at_scale)
+{
+    // the value payload is cold in the frozen layout — keys pack densely in
+    // their own array — so the node-walking and array-walking lookups must
+    // keep agreeing when the working set far exceeds cache
+    auto tree = RBTree<int, std::string>();
+    for (int i = 0; i < 100000; ++i) { tree[3 * i] = std::to_string(i); }
+
+    auto frozen = datastructure::freeze(tree);
+    ASSERT_EQ(frozen.size(), tree.size());
+
+    unsigned hits = 0;
+    unsigned seed = 12345;
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1664525u + 1013904223u;       // cheap LCG, no <random> setup
+        auto key = int(seed % 300000u);
+        auto it = tree.find(key);
+        const auto * slot = frozen.find(key);
+        if (it != tree.end()) {
+            ASSERT_NE(slot, nullptr);
+            ASSERT_EQ(*slot, it->second);
+            hits += 1;
+        } else {
+            ASSERT_EQ(slot, nullptr);
+        }
+    }
+    EXPECT_GT(hits, 0u);
+}
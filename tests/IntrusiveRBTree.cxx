@@ -0,0 +1,94 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "IntrusiveRBTree.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Item : datastructure::RBHook
+{
+    int         key = 0;
+    unsigned    payload = 0;
+
+    friend bool operator<(const Item & lhs, const Item & rhs) { return lhs.key < rhs.key; }
+    friend bool operator<(const Item & lhs, int rhs) { return lhs.key < rhs; }
+    friend bool operator<(int lhs, const Item & rhs) { return lhs < rhs.key; }
+};
+
+} // namespace
+
+TEST(IntrusiveRBTree, requirements)
+{
+    using IntrusiveRBTree = typename datastructure::IntrusiveRBTree<Item>;
+
+    static_assert(std::is_default_constructible_v<IntrusiveRBTree>);
+    static_assert(!std::is_copy_constructible_v<IntrusiveRBTree>);
+    static_assert(!std::is_move_constructible_v<IntrusiveRBTree>);
+    static_assert(std::is_same_v<Item, typename IntrusiveRBTree::value_type>);
+
+    SUCCEED();
+}
+
+TEST(IntrusiveRBTree, basic_operations)
+{
+    auto items = std::vector<Item>(10);
+    for (int i = 0; i < 10; ++i) { items[std::size_t(i)].key = i; items[std::size_t(i)].payload = unsigned(i) * 10u; }
+
+    auto tree = datastructure::IntrusiveRBTree<Item>();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.find(0), nullptr);
+
+    // link in shuffled order, reject a duplicate
+    const int order[10] = {5, 2, 8, 0, 9, 1, 7, 3, 6, 4};
+    for (int key : order) { EXPECT_TRUE(tree.insert(items[std::size_t(key)])); }
+    EXPECT_FALSE(tree.insert(items[5]));
+    EXPECT_EQ(tree.size(), 10u);
+
+    // find reaches the very objects the caller owns, by heterogeneous key
+    for (int i = 0; i < 10; ++i) {
+        auto * found = tree.find(i);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(found, &items[std::size_t(i)]);
+        EXPECT_EQ(found->payload, unsigned(i) * 10u);
+    }
+    EXPECT_EQ(tree.find(10), nullptr);
+
+    // iteration runs in key order
+    int expected = 0;
+    for (const auto & item : tree) { EXPECT_EQ(item.key, expected); expected += 1; }
+    EXPECT_EQ(expected, 10);
+
+    // unlinking leaves the objects themselves untouched
+    tree.erase(items[4]);
+    EXPECT_EQ(tree.size(), 9u);
+    EXPECT_EQ(tree.find(4), nullptr);
+    EXPECT_EQ(items[4].payload, 40u);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.find(5), nullptr);
+}
+
+TEST(IntrusiveRBTree, mixed_workload)
+{
+    constexpr int count = 1000;
+    auto items = std::vector<Item>(count);
+    for (int i = 0; i < count; ++i) { items[std::size_t(i)].key = i; }
+
+    auto order = std::vector<int>(count);
+    for (int i = 0; i < count; ++i) { order[std::size_t(i)] = i; }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    auto tree = datastructure::IntrusiveRBTree<Item>();
+    for (int key : order) { tree.insert(items[std::size_t(key)]); }
+    for (int key = 0; key < count; key += 2) { tree.erase(items[std::size_t(key)]); }
+    EXPECT_EQ(tree.size(), count / 2);
+
+    int expected = 1;
+    for (const auto & item : tree) { EXPECT_EQ(item.key, expected); expected += 2; }
+    EXPECT_EQ(expected, count + 1);
+}
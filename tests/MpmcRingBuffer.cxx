@@ -0,0 +1,75 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "MpmcRingBuffer.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(MpmcRingBuffer, requirements)
+{
+    using MpmcRingBuffer = typename datastructure::MpmcRingBuffer<int, 4>;
+
+    static_assert(std::is_default_constructible_v<MpmcRingBuffer>);
+    static_assert(!std::is_copy_constructible_v<MpmcRingBuffer>);
+    static_assert(!std::is_move_constructible_v<MpmcRingBuffer>);
+    static_assert(std::is_same_v<int *, typename MpmcRingBuffer::value_type>);
+
+    SUCCEED();
+}
+
+TEST(MpmcRingBuffer, single_thread)
+{
+    auto buffer = datastructure::MpmcRingBuffer<int, 4>();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.try_pop(), nullptr);
+
+    int items[5] = {0, 1, 2, 3, 4};
+    for (int i = 0; i < 4; ++i) { EXPECT_TRUE(buffer.try_push(&items[i])); }
+    EXPECT_FALSE(buffer.try_push(&items[4]));   // full
+    EXPECT_EQ(buffer.size(), 4);
+
+    for (int i = 0; i < 4; ++i) { EXPECT_EQ(buffer.try_pop(), &items[i]); }
+    EXPECT_EQ(buffer.try_pop(), nullptr);       // empty
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(MpmcRingBuffer, many_threads)
+{
+    constexpr int perProducer = 20000;
+    constexpr int producers = 2;
+    constexpr int consumers = 2;
+
+    auto buffer = datastructure::MpmcRingBuffer<int, 64>();
+    auto items = std::vector<int>(producers * perProducer);
+    for (std::size_t i = 0; i < items.size(); ++i) { items[i] = int(i); }
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+
+    auto workers = std::vector<std::thread>();
+    for (int p = 0; p < producers; ++p) {
+        workers.emplace_back([&items, &buffer, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                auto * item = &items[std::size_t(p * perProducer + i)];
+                while (!buffer.try_push(item)) { std::this_thread::yield(); }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        workers.emplace_back([&buffer, &sum, &received] {
+            while (received.load() < producers * perProducer) {
+                if (auto * item = buffer.try_pop()) {
+                    sum += *item;
+                    received += 1;
+                }
+            }
+        });
+    }
+    for (auto & worker : workers) { worker.join(); }
+
+    const auto count = static_cast<long long>(producers) * perProducer;
+    EXPECT_EQ(sum, count * (count - 1) / 2);    // every item seen exactly once
+    EXPECT_TRUE(buffer.empty());
+}
@@ -29,6 +29,7 @@ TEST(RingBuffer, requirements_int) {
     static_assert(noexcept(std::declval<RingBuffer>().pop()));
     static_assert(noexcept(std::declval<RingBuffer>().clear()));
     static_assert(noexcept(std::declval<RingBuffer>().empty()));
+    static_assert(noexcept(std::declval<RingBuffer>().full()));
     static_assert(noexcept(std::declval<RingBuffer>().size()));
 
     SUCCEED();
@@ -75,12 +76,14 @@ TEST(RingBuffer, integer) {
     buffer.push(44);
     buffer.push(45);
     EXPECT_FALSE(buffer.empty());
+    EXPECT_TRUE(buffer.full());
     EXPECT_EQ(buffer.size(), 4);
     EXPECT_EQ(buffer.capacity(), 4);
     EXPECT_EQ(buffer.max_size(), 4);
     EXPECT_EQ(buffer.front(), 42);
 
     buffer.pop();
+    EXPECT_FALSE(buffer.full());
     EXPECT_EQ(buffer.size(), 3);
     EXPECT_EQ(buffer.front(), 43);
     buffer.pop();
@@ -163,3 +166,27 @@ TEST(RingBuffer, lifecycle) {
     buffer.clear();
     EXPECT_EQ(Lifecycle::destructor, 4);
 }
+
+TEST(RingBuffer, bulk) {
+    using RingBuffer = typename datastructure::RingBuffer<int, 4>;
+
+    auto buffer = RingBuffer();
+    const int in[] = {1, 2, 3, 4, 5};
+    EXPECT_EQ(buffer.push_bulk(in, 5), 4);      // clamped to available space
+    EXPECT_EQ(buffer.size(), 4);
+
+    int out[4] = {};
+    EXPECT_EQ(buffer.pop_bulk(out, 2), 2);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[1], 2);
+
+    EXPECT_EQ(buffer.push_bulk(in + 4, 1), 1);  // wraps around storage end
+    EXPECT_EQ(buffer.size(), 3);
+
+    int rest[4] = {};
+    EXPECT_EQ(buffer.pop_bulk(rest, 4), 3);     // clamped to available elements
+    EXPECT_EQ(rest[0], 3);
+    EXPECT_EQ(rest[1], 4);
+    EXPECT_EQ(rest[2], 5);
+    EXPECT_TRUE(buffer.empty());
+}
@@ -0,0 +1,73 @@
+/* Copyright 2019 Julien Hartmann
+ */
+#include "SpscRingBuffer.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+TEST(SpscRingBuffer, requirements)
+{
+    using SpscRingBuffer = typename datastructure::SpscRingBuffer<int, 4>;
+
+    static_assert(std::is_default_constructible_v<SpscRingBuffer>);
+    static_assert(!std::is_copy_constructible_v<SpscRingBuffer>);
+    static_assert(!std::is_move_constructible_v<SpscRingBuffer>);
+
+    static_assert(std::is_same_v<int, typename SpscRingBuffer::value_type>);
+    static_assert(std::is_unsigned_v<typename SpscRingBuffer::size_type>);
+
+    SUCCEED();
+}
+
+TEST(SpscRingBuffer, single_thread)
+{
+    auto buffer = datastructure::SpscRingBuffer<std::string, 4>();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.capacity(), 4);
+
+    EXPECT_TRUE(buffer.try_push("a"));
+    EXPECT_TRUE(buffer.try_push("b"));
+    EXPECT_TRUE(buffer.try_emplace(std::size_t{3}, 'c'));
+    EXPECT_TRUE(buffer.try_push("d"));
+    EXPECT_FALSE(buffer.try_push("e"));     // full
+    EXPECT_EQ(buffer.size(), 4);
+
+    std::string out;
+    EXPECT_TRUE(buffer.try_pop(out));
+    EXPECT_EQ(out, "a");
+    EXPECT_TRUE(buffer.try_pop(out));
+    EXPECT_EQ(out, "b");
+    EXPECT_TRUE(buffer.try_pop(out));
+    EXPECT_EQ(out, "ccc");
+    EXPECT_TRUE(buffer.try_pop(out));
+    EXPECT_EQ(out, "d");
+    EXPECT_FALSE(buffer.try_pop(out));      // empty
+}
+
+TEST(SpscRingBuffer, two_threads)
+{
+    constexpr int count = 100000;
+    auto buffer = datastructure::SpscRingBuffer<int, 64>();
+
+    auto producer = std::thread([&buffer] {
+        for (int i = 0; i < count; ++i) {
+            while (!buffer.try_push(i)) { std::this_thread::yield(); }
+        }
+    });
+
+    long long sum = 0;
+    int received = 0;
+    while (received < count) {
+        int value;
+        if (buffer.try_pop(value)) {
+            EXPECT_EQ(value, received);     // order is preserved
+            sum += value;
+            received += 1;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(sum, static_cast<long long>(count) * (count - 1) / 2);
+    EXPECT_TRUE(buffer.empty());
+}
@@ -3,8 +3,48 @@
 #ifndef DATASTRUCTURES_TESTS_ALLOCATORS_H
 #define DATASTRUCTURES_TESTS_ALLOCATORS_H
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// tells the compiler the returned block is fresh — aliases nothing live and
+// is never null — so it can keep values in registers across allocation calls.
+// always_inline overrides size heuristics that sometimes leave the counter
+// bump as an out-of-line call inside tight insertion loops
+#if defined(__GNUC__)
+#   define TEST_ALLOC_ATTR [[gnu::malloc, gnu::returns_nonnull, gnu::always_inline]]
+#   define TEST_DEALLOC_ATTR [[gnu::nonnull, gnu::always_inline]]
+#else
+#   define TEST_ALLOC_ATTR
+#   define TEST_DEALLOC_ATTR
+#endif
+
+// clang's builtin forms take the same arguments as the operators but are not
+// replaceable, so the optimizer may elide or merge the calls outright
+#if defined(__has_builtin)
+#   if __has_builtin(__builtin_operator_new) && __has_builtin(__builtin_operator_delete)
+#       define TEST_OPERATOR_NEW __builtin_operator_new
+#       define TEST_OPERATOR_DELETE __builtin_operator_delete
+#   endif
+#endif
+#ifndef TEST_OPERATOR_NEW
+#   define TEST_OPERATOR_NEW ::operator new
+#   define TEST_OPERATOR_DELETE ::operator delete
+#endif
+
 namespace testing {
 
+/// Allocation and deallocation tallies for counting_allocator. Bundling both
+/// in one block keeps the allocator at a single pointer, so copies are cheap
+/// and equality is one comparison. Atomic so the fixture stays usable from
+/// concurrent tests; relaxed increments are counts, not synchronization.
+struct Counters {
+    std::atomic<unsigned> allocs = 0;
+    std::atomic<unsigned> deallocs = 0;
+};
+
 template <typename T>
 class counting_allocator {
 public:
@@ -14,29 +54,40 @@ public:
     using propagate_on_container_swap = std::true_type;
 
 public:
-    counting_allocator(unsigned * allocations, unsigned * deallocations)
-     : m_allocations(allocations),
-       m_deallocations(deallocations) {}
+    // null counters fall back to a discard slot, so allocate/deallocate can
+    // bump unconditionally instead of testing the pointer on every call
+    counting_allocator(Counters * counters)
+     : m_counters(counters ? counters : &s_unused) {}
 
     template <typename U>
     counting_allocator(const counting_allocator<U> & other)
-     : m_allocations(other.m_allocations),
-       m_deallocations(other.m_deallocations) {}
+     : m_counters(other.m_counters) {}
 
-    [[nodiscard]] T * allocate(std::size_t n)
+    [[nodiscard]] TEST_ALLOC_ATTR T * allocate(std::size_t n)
     {
-        if (m_allocations) { *m_allocations += 1; }
-        return static_cast<T *>(::operator new(n * sizeof(T), static_cast<std::align_val_t>(alignof(T))));
+        m_counters->allocs.fetch_add(1, std::memory_order_relaxed);
+        // the aligned overload may route through posix_memalign — only worth
+        // it for types new's default alignment cannot serve
+        if constexpr (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return static_cast<T *>(TEST_OPERATOR_NEW(n * sizeof(T)));
+        } else {
+            return static_cast<T *>(TEST_OPERATOR_NEW(n * sizeof(T), static_cast<std::align_val_t>(alignof(T))));
+        }
     }
-    void deallocate(T * ptr, std::size_t)
+    TEST_DEALLOC_ATTR void deallocate(T * ptr, std::size_t n)
     {
-        if (m_deallocations) { *m_deallocations += 1; }
-        ::operator delete(ptr, static_cast<std::align_val_t>(alignof(T)));
+        m_counters->deallocs.fetch_add(1, std::memory_order_relaxed);
+        // sized form: spares the heap a metadata lookup to recover the size
+        if constexpr (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            TEST_OPERATOR_DELETE(ptr, n * sizeof(T));
+        } else {
+            TEST_OPERATOR_DELETE(ptr, n * sizeof(T), static_cast<std::align_val_t>(alignof(T)));
+        }
     }
 
     friend bool operator==(const counting_allocator & lhs, const counting_allocator & rhs)
     {
-        return lhs.m_allocations == rhs.m_allocations && lhs.m_deallocations == rhs.m_deallocations;
+        return lhs.m_counters == rhs.m_counters;
     }
     friend bool operator!=(const counting_allocator & lhs, const counting_allocator & rhs)
     {
@@ -44,13 +95,139 @@ public:
     }
 
 private:
-    unsigned * m_allocations = nullptr;
-    unsigned * m_deallocations = nullptr;
+    inline static Counters s_unused = {};
+
+    Counters * m_counters;
 
     template <typename U> friend class counting_allocator;
 };
 
 
+/// Bump allocator carving objects out of ever-growing shared blocks.
+/// Nothing is freed until the last copy goes away, so deallocate is a no-op
+/// and allocation is a pointer bump. blocks() exposes how many blocks were
+/// grabbed, letting tests assert on allocation pressure.
+struct monotonic_arena {    // shared across rebound copies, hence non-template
+    std::vector<std::unique_ptr<char[]>>    blocks;
+    char *                                  next = nullptr;
+    char *                                  limit = nullptr;
+    std::size_t                             block_size = 32768;
+};
+
+template <typename T>
+class monotonic_allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+public:
+    monotonic_allocator() : m_arena(std::make_shared<monotonic_arena>()) {}
+
+    template <typename U>
+    monotonic_allocator(const monotonic_allocator<U> & other) : m_arena(other.m_arena) {}
+
+    [[nodiscard]] T * allocate(std::size_t n)
+    {
+        auto size = n * sizeof(T);
+        void * ptr = m_arena->next;
+        auto space = std::size_t(m_arena->limit - m_arena->next);
+        if (!ptr || !std::align(alignof(T), size, ptr, space)) {
+            auto block = m_arena->block_size < size + alignof(T) ? size + alignof(T)
+                                                                 : m_arena->block_size;
+            m_arena->blocks.push_back(std::make_unique<char[]>(block));
+            m_arena->next = m_arena->blocks.back().get();
+            m_arena->limit = m_arena->next + block;
+            m_arena->block_size *= 2;
+            ptr = m_arena->next;
+            space = block;
+            std::align(alignof(T), size, ptr, space);
+        }
+        m_arena->next = static_cast<char *>(ptr) + size;
+        return static_cast<T *>(ptr);
+    }
+    void deallocate(T *, std::size_t) {}    // storage lives until the arena does
+
+    std::size_t blocks() const { return m_arena->blocks.size(); }
+
+    friend bool operator==(const monotonic_allocator & lhs, const monotonic_allocator & rhs)
+    {
+        return lhs.m_arena == rhs.m_arena;
+    }
+    friend bool operator!=(const monotonic_allocator & lhs, const monotonic_allocator & rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::shared_ptr<monotonic_arena>    m_arena;
+
+    template <typename U> friend class monotonic_allocator;
+};
+
+
+// tallies shared by every pool_allocator specialization — a tree allocates
+// nodes through a rebound copy, so a per-type counter would be unreachable
+// from test code naming only the value type
+struct pool_stats {
+    inline static thread_local std::size_t fresh = 0;
+};
+
+/// LIFO free-list allocator: freed single-object blocks go onto a per-type
+/// thread-local list and are handed straight back on the next allocation, so
+/// steady-state insert/erase cycles never touch the heap. fresh_allocations()
+/// counts how many blocks actually came from operator new, letting tests
+/// assert that memory is being recycled. Pooled blocks are kept for the
+/// lifetime of the thread.
+template <typename T>
+class pool_allocator {
+    union Chunk {
+        Chunk *                                         next;
+        std::aligned_storage_t<sizeof(T), alignof(T)>   storage;
+    };
+public:
+    using value_type = T;
+
+public:
+    pool_allocator() = default;
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U> &) {}
+
+    [[nodiscard]] T * allocate(std::size_t n)
+    {
+        if (n == 1) {
+            if (auto * chunk = s_freelist) {
+                s_freelist = chunk->next;
+                return reinterpret_cast<T *>(chunk);
+            }
+            pool_stats::fresh += 1;
+            return static_cast<T *>(::operator new(sizeof(Chunk)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T * ptr, std::size_t n)
+    {
+        if (n == 1) {
+            auto * chunk = reinterpret_cast<Chunk *>(ptr);
+            chunk->next = s_freelist;
+            s_freelist = chunk;
+            return;
+        }
+        ::operator delete(ptr, n * sizeof(T));
+    }
+
+    static std::size_t fresh_allocations() { return pool_stats::fresh; }
+
+    friend bool operator==(const pool_allocator &, const pool_allocator &) { return true; }
+    friend bool operator!=(const pool_allocator &, const pool_allocator &) { return false; }
+
+private:
+    inline static thread_local Chunk *  s_freelist = nullptr;
+};
+
+
 } // namespace testing
 
 #endif
@@ -4,31 +4,39 @@
 
 #include "allocators.h"
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 using datastructure::RBTree;
 
+// expected values for the five-entry fixtures, indexed by key — keeps
+// assertion loops free of std::to_string's per-call allocation
+static constexpr const char * expectedValue[] = {"", "1", "2", "3", "4", "5"};
+
 TEST(RBTree, requirements)
 {
     using type = RBTree<int, std::string>;
 
-    // Container requirements
-    static_assert(std::is_same_v<type::key_type, int>);
-    static_assert(std::is_same_v<type::mapped_type, std::string>);
-    static_assert(std::is_same_v<type::value_type, std::pair<const int, std::string>>);
-    static_assert(std::is_same_v<type::key_compare, std::less<int>>);
-    static_assert(std::is_same_v<type::allocator_type, std::allocator<std::string>>);
-    static_assert(std::is_same_v<type::reference, std::string &>);
-    static_assert(std::is_same_v<type::const_reference, std::string const &>);
-    static_assert(std::is_same_v<typename type::difference_type, std::ptrdiff_t>);
-    static_assert(std::is_same_v<typename type::size_type, std::size_t>);
-
-    static_assert(std::is_default_constructible_v<type>);
-    static_assert(std::is_copy_constructible_v<type>);
-    static_assert(std::is_move_constructible_v<type>);
-    static_assert(std::is_copy_assignable_v<type>);
-    static_assert(std::is_move_assignable_v<type>);
-    static_assert(std::is_destructible_v<type>);
+    // Container requirements, folded into one assertion each so the compiler
+    // evaluates a single conjunction per aspect instead of fifteen separate
+    // static_assert instantiations
+    static_assert(std::is_same_v<type::key_type, int> &&
+                  std::is_same_v<type::mapped_type, std::string> &&
+                  std::is_same_v<type::value_type, std::pair<const int, std::string>> &&
+                  std::is_same_v<type::key_compare, std::less<int>> &&
+                  std::is_same_v<type::allocator_type, std::allocator<std::string>> &&
+                  std::is_same_v<type::reference, std::string &> &&
+                  std::is_same_v<type::const_reference, std::string const &> &&
+                  std::is_same_v<typename type::difference_type, std::ptrdiff_t> &&
+                  std::is_same_v<typename type::size_type, std::size_t>);
+
+    static_assert(std::is_default_constructible_v<type> &&
+                  std::is_copy_constructible_v<type> &&
+                  std::is_move_constructible_v<type> &&
+                  std::is_copy_assignable_v<type> &&
+                  std::is_move_assignable_v<type> &&
+                  std::is_destructible_v<type>);
 
     SUCCEED();
 }
@@ -47,83 +55,232 @@ TEST(RBTree, basic_lifecycle)
 
     tree.clear();
     EXPECT_TRUE(tree.empty());
+    // existence checks go through find, which stays off the throwing path
+    EXPECT_EQ(tree.find(0), tree.end());
+}
+
+TEST(RBTree, missing_key_throws)
+{
+    // kept apart from basic_lifecycle: EXPECT_THROW pays for stack
+    // unwinding, which would pollute any timing done on the happy path
+    auto tree = RBTree<int, std::string>();
+    EXPECT_THROW(tree.at(0), std::out_of_range);
+
+    tree[0] = "value";
+    tree.clear();
     EXPECT_THROW(tree.at(0), std::out_of_range);
 }
 
-TEST(RBTree, basic_operations)
+// five-entry trees shared by the basic_operations tests — built once per
+// suite so each test starts from a pointer copy instead of five insertions.
+// Tests must not mutate them; erasure coverage works on a local copy.
+class RBTreeFixture : public ::testing::Test {
+protected:
+    static void SetUpTestSuite()
+    {
+        tree = new RBTree<int, std::string>({
+            {1, "1"},
+            {2, "2"},
+            {3, "3"},
+            {4, "4"},
+            {5, "5"}
+        });
+        reversed = new RBTree<int, std::string, std::greater<int>>(
+            tree->begin(), tree->end());
+    }
+    static void TearDownTestSuite()
+    {
+        delete tree;
+        delete reversed;
+        tree = nullptr;
+        reversed = nullptr;
+    }
+
+    inline static RBTree<int, std::string> * tree = nullptr;
+    inline static RBTree<int, std::string, std::greater<int>> * reversed = nullptr;
+};
+
+TEST_F(RBTreeFixture, basic_operations)
 {
-    auto tree = RBTree<int, std::string>({
-        {1, "1"},
-        {2, "2"},
-        {3, "3"},
-        {4, "4"},
-        {5, "5"}
-    });
-    EXPECT_EQ(tree.size(), 5);
+    EXPECT_EQ(tree->size(), 5);
 
-    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(tree.at(i), std::to_string(i)); }
+    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(tree->at(i), expectedValue[i]); }
 
     {
         int i = 1;
-        for (auto & value : tree) {
+        for (auto & value : *tree) {
             EXPECT_EQ(value.first, i);
-            EXPECT_EQ(value.second, std::to_string(i));
+            EXPECT_EQ(value.second, expectedValue[i]);
             i += 1;
         }
     }
 
-    for (int i = 1; i <= 5; i += 2) { tree.erase(i); }
-    EXPECT_EQ(tree.size(), 2);
+    auto local = *tree;
+    for (int i : {1, 3, 5}) { local.erase(i); }
+    EXPECT_EQ(local.size(), 2);
 }
 
-TEST(RBTree, basic_comparator)
+TEST_F(RBTreeFixture, basic_comparator)
 {
-    auto tree = RBTree<int, std::string, std::greater<int>>({
-        {1, "1"},
-        {2, "2"},
-        {3, "3"},
-        {4, "4"},
-        {5, "5"}
-    });
-    EXPECT_EQ(tree.size(), 5);
+    EXPECT_EQ(reversed->size(), 5);
 
-    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(tree.at(i), std::to_string(i)); }
+    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(reversed->at(i), expectedValue[i]); }
 
     {
         int i = 5;
-        for (auto & value : tree) {
+        for (auto & value : *reversed) {
             EXPECT_EQ(value.first, i);
-            EXPECT_EQ(value.second, std::to_string(i));
+            EXPECT_EQ(value.second, expectedValue[i]);
             i -= 1;
         }
     }
 
-    for (int i = 1; i <= 5; i += 2) { tree.erase(i); }
-    EXPECT_EQ(tree.size(), 2);
+    auto local = *reversed;
+    for (int i : {1, 3, 5}) { local.erase(i); }
+    EXPECT_EQ(local.size(), 2);
 }
 
 TEST(RBTree, basic_allocator)
 {
     using Tree = RBTree<int, std::string, std::less<int>, testing::counting_allocator<std::string>>;
-    unsigned allocations = 0, deallocations = 0;
+    testing::Counters counters;
     {
-        auto tree = Tree(testing::counting_allocator<std::string>(&allocations, &deallocations));
+        auto tree = Tree(testing::counting_allocator<std::string>(&counters));
         tree[1] = "hello1";
         tree[2] = "hello2";
         tree[3] = "hello3";
         tree[4] = "hello4";
         tree[1] = "replaced";
         EXPECT_EQ(tree.size(), 4);
-        EXPECT_EQ(allocations, 5);
+        EXPECT_EQ(counters.allocs, 5);
 
         auto treeB = tree;              // propagate on copy construction
         EXPECT_EQ(tree, treeB);
-        EXPECT_EQ(allocations, 10);
+        EXPECT_EQ(counters.allocs, 10);
 
         auto treeC = std::move(tree);   // propagate on move construction
         EXPECT_EQ(tree.size(), 0);
         EXPECT_EQ(treeB, treeC);
-        EXPECT_EQ(allocations, 10);
+        EXPECT_EQ(counters.allocs, 10);
+    }
+    EXPECT_EQ(counters.deallocs, 10);
+}
+
+TEST(RBTree, compact)
+{
+    auto tree = RBTree<int, std::string>();
+    for (int i = 0; i < 200; ++i) { tree[i] = std::to_string(i); }
+    for (int i = 0; i < 200; i += 3) { tree.erase(i); }
+
+    auto before = tree;
+    tree.compact();
+    EXPECT_EQ(tree, before);
+
+    tree.compact();     // idempotent
+    EXPECT_EQ(tree, before);
+
+    auto empty = RBTree<int, std::string>();
+    empty.compact();
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(RBTree, assign_sorted)
+{
+    const std::vector<std::pair<const int, std::string>> sorted = {
+        {1, "1"}, {2, "2"}, {3, "3"}, {4, "4"}, {5, "5"}
+    };
+
+    auto tree = RBTree<int, std::string>(sorted.begin(), sorted.end());
+    EXPECT_EQ(tree.size(), 5);
+    for (int i = 1; i <= 5; ++i) { EXPECT_EQ(tree.at(i), expectedValue[i]); }
+
+    tree.erase(3);
+    tree.assign_sorted(sorted.begin(), sorted.end());
+    EXPECT_EQ(tree.size(), 5);
+    {
+        int i = 1;
+        for (auto & value : tree) { EXPECT_EQ(value.first, i); i += 1; }
+    }
+
+    // unsorted input still goes through regular insertion
+    const std::vector<std::pair<const int, std::string>> shuffled = {
+        {4, "4"}, {1, "1"}, {5, "5"}, {2, "2"}, {3, "3"}
+    };
+    auto other = RBTree<int, std::string>(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(other, tree);
+}
+
+TEST(RBTree, insert_1M_stress)
+{
+    constexpr int count = 1 << 20;
+
+    // ordered fills are the classic worst case for unbalanced trees: any
+    // regression towards linear depth turns these loops quadratic and runs
+    // into the test timeout long before they complete
+    auto verify = [](RBTree<int, int> & tree) {
+        ASSERT_EQ(tree.size(), std::size_t(count));
+        int expected = 0, mismatches = 0;
+        for (auto & value : tree) {
+            if (value.first != expected) { mismatches += 1; }
+            expected += 1;
+        }
+        EXPECT_EQ(mismatches, 0);
+
+        for (int i = 0; i < count; i += 2) { tree.erase(i); }
+        EXPECT_EQ(tree.size(), std::size_t(count / 2));
+    };
+
+    {   // sequential
+        auto tree = RBTree<int, int>();
+        for (int i = 0; i < count; ++i) { tree[i] = i; }
+        verify(tree);
+    }
+    {   // reverse-sorted
+        auto tree = RBTree<int, int>();
+        for (int i = count - 1; i >= 0; --i) { tree[i] = i; }
+        verify(tree);
+    }
+    {   // pseudo-random: odd multiplier modulo a power of two permutes the keys
+        auto tree = RBTree<int, int>();
+        for (int i = 0; i < count; ++i) {
+            auto key = int((std::uint32_t(i) * 2654435761u) & (count - 1));
+            tree[key] = key;
+        }
+        verify(tree);
+    }
+}
+
+TEST(RBTree, pool_allocator_reuses_nodes)
+{
+    using Alloc = testing::pool_allocator<std::pair<const int, int>>;
+    constexpr int count = 1000;
+
+    auto before = Alloc::fresh_allocations();
+    auto tree = RBTree<int, int, std::less<int>, Alloc>();
+    for (int i = 0; i < count; ++i) { tree[i] = i; }
+    // one block per node plus the nil sentinel, all fresh
+    EXPECT_EQ(Alloc::fresh_allocations() - before, std::size_t(count + 1));
+
+    for (int i = 0; i < count; ++i) { tree.erase(i); }
+    auto recycled = Alloc::fresh_allocations();
+    for (int i = 0; i < count; ++i) { tree[i] = i; }
+
+    // the second fill is served entirely from the free list
+    EXPECT_EQ(Alloc::fresh_allocations(), recycled);
+    EXPECT_EQ(tree.size(), std::size_t(count));
+}
+
+TEST(RBTree, arena_allocator)
+{
+    auto alloc = testing::monotonic_allocator<std::pair<const int, int>>();
+    {
+        auto tree = RBTree<int, int, std::less<int>,
+                           testing::monotonic_allocator<std::pair<const int, int>>>(alloc);
+        for (int i = 0; i < 100000; ++i) { tree[i] = i; }
+        EXPECT_EQ(tree.size(), 100000u);
+
+        // a pointer bump per node, a real allocation only when a block fills:
+        // doubling block sizes mean O(log n) blocks, not one call per insert
+        EXPECT_LE(alloc.blocks(), 10u);
     }
-    EXPECT_EQ(deallocations, 10);
 }